@@ -0,0 +1,102 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare,
+ *  Matthew Hausknecht, and the Reinforcement Learning and Artificial Intelligence
+ *  Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  cpuLockstepExample.cpp
+ *
+ *  Runs the same game on two CPU cores side by side and checks, after every
+ *  action, that both emulators are in exactly the same state. It also reports
+ *  the time each core spent in act(); since the actions alternate between the
+ *  cores, both see the same machine load.
+ **************************************************************************** */
+
+#include <chrono>
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <ale_interface.hpp>
+
+using namespace std;
+
+static void setUp(ALEInterface& ale, const char* cpu, const char* render_mode,
+                  const char* rom_file) {
+    ale.setInt("random_seed", 123);
+    ale.setString("cpu", cpu);
+    ale.setString("render_mode", render_mode);
+    ale.loadROM(rom_file);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " rom_file [steps] [cpu_a] [cpu_b] [render_mode]" << std::endl;
+        return 1;
+    }
+    int steps = argc > 2 ? atoi(argv[2]) : 10000;
+    const char* cpu_a = argc > 3 ? argv[3] : "low";
+    const char* cpu_b = argc > 4 ? argv[4] : "fast";
+    const char* render_mode = argc > 5 ? argv[5] : "all";
+
+    ALEInterface ale_a, ale_b;
+    setUp(ale_a, cpu_a, render_mode, argv[1]);
+    setUp(ale_b, cpu_b, render_mode, argv[1]);
+
+    ActionVect legal_actions = ale_a.getLegalActionSet();
+    srand(123);
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::duration time_a = Clock::duration::zero();
+    Clock::duration time_b = Clock::duration::zero();
+
+    for (int step = 0; step < steps; step++) {
+        Action a = legal_actions[rand() % legal_actions.size()];
+        Clock::time_point start = Clock::now();
+        reward_t reward_a = ale_a.act(a);
+        Clock::time_point middle = Clock::now();
+        reward_t reward_b = ale_b.act(a);
+        time_a += middle - start;
+        time_b += Clock::now() - middle;
+
+        // The serialized system state covers the CPU, RIOT, TIA and cartridge
+        const char* divergence = NULL;
+        if (reward_a != reward_b) {
+            divergence = "reward";
+        } else if (ale_a.game_over() != ale_b.game_over()) {
+            divergence = "terminal flag";
+        } else if (memcmp(ale_a.getRAM().array(), ale_b.getRAM().array(), RAM_SIZE) != 0) {
+            divergence = "RAM";
+        } else if (memcmp(ale_a.getScreen().getArray(), ale_b.getScreen().getArray(),
+                          ale_a.getScreen().arraySize()) != 0) {
+            divergence = "screen";
+        } else if (ale_a.cloneSystemState().serialize() != ale_b.cloneSystemState().serialize()) {
+            divergence = "system state";
+        }
+
+        if (divergence != NULL) {
+            cout << "Cores '" << cpu_a << "' and '" << cpu_b << "' diverge at step "
+                 << step << " (frame " << ale_a.getFrameNumber() << "): " << divergence
+                 << " differs" << endl;
+            return 1;
+        }
+
+        if (ale_a.game_over()) {
+            ale_a.reset_game();
+            ale_b.reset_game();
+        }
+    }
+
+    cout << "Cores '" << cpu_a << "' and '" << cpu_b << "' agree over " << steps
+         << " steps" << endl;
+
+    double seconds_a = std::chrono::duration<double>(time_a).count();
+    double seconds_b = std::chrono::duration<double>(time_b).count();
+    cout << "Time in act(): '" << cpu_a << "' " << seconds_a << " s, '" << cpu_b << "' "
+         << seconds_b << " s (" << seconds_a / seconds_b << "x)" << endl;
+    return 0;
+}
@@ -84,6 +84,63 @@ bool readData(FILE* alePipe) {
 }
 
 
+// Read in one frame of the binary protocol: type, payload length and payload.
+char readFrame(FILE* alePipe, std::vector<unsigned char>& payload) {
+    unsigned char header[5];
+    if (fread(header, 1, 5, alePipe) != 5) return 'D';
+
+    size_t length = header[1] | (header[2] << 8) | (header[3] << 16) | (header[4] << 24);
+    payload.resize(length);
+    if (length > 0 && fread(&payload[0], 1, length, alePipe) != length) return 'D';
+    return header[0];
+}
+
+
+// Same as agentMain(), with the binary protocol.
+void binaryAgentMain(FILE* alePipe) {
+
+    // Read in screen width and height
+    char buffer[1024];
+    fgets(buffer, sizeof(buffer), alePipe);
+
+    std::cout << "ALE says: " << buffer << std::endl;
+
+    // Request RAM & RL data from ALE, with the binary protocol (last field)
+    fputs("0,1,0,1,1\n", alePipe);
+    fflush(alePipe);
+
+    int numActions = 0;
+    std::vector<unsigned char> payload;
+
+    // Each observation holds the 128 bytes of RAM, then the terminal flag, then the
+    // reward and the number of actions applied as 32-bit little-endian integers
+    while (readFrame(alePipe, payload) == 'O') {
+        int reward = (int)(payload[129] | (payload[130] << 8) | (payload[131] << 16) |
+                           (payload[132] << 24));
+        if (reward != 0)
+            std::cout << "Reward: " << reward << std::endl;
+
+        // The last batch stops early if it ends the episode
+        numActions += payload[133] | (payload[134] << 8) | (payload[135] << 16) |
+                      (payload[136] << 24);
+
+        if (payload[128]) break;
+
+        // Write back a batch of four copies of a random action
+        unsigned char action = randInRange(17);
+        unsigned char frame[5 + 8] = { 'A', 8, 0, 0, 0 };
+        for (int i = 0; i < 4; i++) {
+            frame[5 + 2 * i] = action;
+            frame[5 + 2 * i + 1] = 18;
+        }
+        fwrite(frame, 1, sizeof(frame), alePipe);
+        fflush(alePipe);
+    }
+
+    std::cout << "Episode lasted " << numActions << " actions" << std::endl;
+}
+
+
 void agentMain(FILE* alePipe) {
 
     // Read in screen width and height
@@ -118,7 +175,7 @@ void agentMain(FILE* alePipe) {
 int main(int argc, char** argv) {
 
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " rom_file" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " rom_file [binary]" << std::endl;
         std::cerr << "Note: This example must be run from the same directory as the ALE "
             "executable ('ale')." << std::endl;
         return 1;
@@ -135,7 +192,10 @@ int main(int argc, char** argv) {
     FILE* alePipe = popen(aleCmd.c_str(), "r+");
     
     // Now run the agent & communicate with the ale
-    agentMain(alePipe);
+    if (argc > 2 && std::string(argv[2]) == "binary")
+        binaryAgentMain(alePipe);
+    else
+        agentMain(alePipe);
 
     pclose(alePipe);
 }
@@ -0,0 +1,118 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare,
+ *  Matthew Hausknecht, and the Reinforcement Learning and Artificial Intelligence
+ *  Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  shmInterfaceExample.cpp
+ *
+ *  Sample code for running an agent in its own process with the shared memory
+ *  interface. Start ALE first, e.g.
+ *
+ *    ./ale -game_controller shm roms/breakout.bin
+ *
+ *  then run this program, with the same shm_name if it was changed.
+ **************************************************************************** */
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <shm_transport.hpp>
+
+// Player A actions; see Constants.h
+#define NUM_ACTIONS (18)
+#define PLAYER_B_NOOP (18)
+#define SYSTEM_RESET (45)
+
+// How long to wait for ALE to create the segment, and then for each observation
+#define ATTACH_TIMEOUT_MS (30000)
+#define OBSERVATION_TIMEOUT_MS (60000)
+
+/* Maps the segment created by ALE, waiting for ALE to set it up if needed */
+static ALEShmHeader* attach(const char* name, size_t& size) {
+    for (int waited_ms = 0; waited_ms < ATTACH_TIMEOUT_MS; waited_ms += 10) {
+        int fd = shm_open(name, O_RDWR, 0);
+        if (fd >= 0) {
+            struct stat st;
+            if (fstat(fd, &st) == 0 && (size_t)st.st_size > sizeof(ALEShmHeader)) {
+                size = st.st_size;
+                void* base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                close(fd);
+                if (base == MAP_FAILED) {
+                    std::cerr << "Cannot map " << name << std::endl;
+                    exit(1);
+                }
+                ALEShmHeader* header = (ALEShmHeader*)base;
+                for (; waited_ms < ATTACH_TIMEOUT_MS; waited_ms++) {
+                    if (aleShmLoad(&header->magic) == ALE_SHM_MAGIC) return header;
+                    usleep(1000);
+                }
+                break;
+            }
+            close(fd);
+        }
+        usleep(10000);
+    }
+    std::cerr << "Timed out waiting for ALE to create " << name << std::endl;
+    exit(1);
+}
+
+int main(int argc, char** argv) {
+    const char* name = argc > 1 ? argv[1] : "/ale_shm";
+
+    size_t size;
+    ALEShmHeader* header = attach(name, size);
+    if (header->version != ALE_SHM_VERSION) {
+        std::cerr << "Unsupported shared memory layout version " << header->version << std::endl;
+        return 1;
+    }
+    aleShmStore(&header->agent_pid, (uint32_t)getpid());
+    std::cerr << "Attached to " << name << ": screen " << header->screen_width << "x"
+              << header->screen_height << ", " << header->num_slots << " slots" << std::endl;
+
+    uint32_t obs_seq = 0;
+    uint32_t act_seq = aleShmLoad(&header->act_seq);
+    int episode = 0;
+    long episode_reward = 0;
+
+    for (;;) {
+        // Wait for the next observation, giving up if ALE died or hangs
+        if (!aleShmWaitObservation(header, obs_seq, OBSERVATION_TIMEOUT_MS)) {
+            std::cerr << "ALE stopped responding" << std::endl;
+            break;
+        }
+        obs_seq = aleShmLoad(&header->obs_seq);
+        if (aleShmLoad(&header->terminated)) break;
+
+        // The observation is read in place; it is not overwritten before we act
+        const ALEShmSlot* slot = aleShmSlot(header, obs_seq);
+        const unsigned char* ram = (const unsigned char*)slot + header->ram_offset;
+        const unsigned char* screen = (const unsigned char*)slot + header->screen_offset;
+        (void)ram; (void)screen;
+
+        episode_reward += slot->reward;
+        if (slot->terminal) {
+            std::cout << "Episode " << episode << " ended with score: " << episode_reward
+                      << std::endl;
+            episode++;
+            episode_reward = 0;
+            header->action_a = SYSTEM_RESET;
+        } else {
+            header->action_a = rand() % NUM_ACTIONS;
+        }
+        header->action_b = PLAYER_B_NOOP;
+        aleShmPublish(&header->act_seq, ++act_seq, &header->ale_waiting);
+    }
+
+    munmap(header, size);
+    return 0;
+}
@@ -233,6 +233,7 @@ void ALEInterface::setFloat(const std::string& key, const float value) {
 
 // Resets the game, but not the full system.
 void ALEInterface::reset_game() {
+  if (m_trajectory.get() != NULL) m_trajectory->addReset();
   environment->reset();
 }
 
@@ -254,11 +255,14 @@ int ALEInterface::lives() {
 // when necessary - this method will keep pressing buttons on the
 // game over screen.
 reward_t ALEInterface::act(Action action) {
+  if (m_trajectory.get() != NULL) m_trajectory->addAction(action);
   reward_t reward = environment->act(action, PLAYER_B_NOOP);
   if (theOSystem->p_display_screen != NULL) {
     theOSystem->p_display_screen->display_screen();
     while (theOSystem->p_display_screen->manual_control_engaged()) {
       Action user_action = theOSystem->p_display_screen->getUserAction();
+      // Each action of the user is a step of its own in the trajectory
+      if (m_trajectory.get() != NULL) m_trajectory->addAction(user_action);
       reward += environment->act(user_action, PLAYER_B_NOOP);
       theOSystem->p_display_screen->display_screen();
     }
@@ -362,6 +366,37 @@ void ALEInterface::getScreenRGB(std::vector<unsigned char>& output_rgb_buffer) {
   theOSystem->colourPalette().applyPaletteRGB(output_rgb_buffer, ale_screen_data, screen_size);
 }
 
+void ALEInterface::getScreenGrayscale(unsigned char* output_buffer) {
+  const ALEScreen& screen = environment->getScreen();
+  theOSystem->colourPalette().applyPaletteGrayscale(output_buffer,
+      (const uInt8*)screen.getArray(), screen.arraySize());
+}
+
+void ALEInterface::getScreenRGB(unsigned char* output_buffer, ColourPalette::Layout layout) {
+  const ALEScreen& screen = environment->getScreen();
+  theOSystem->colourPalette().applyPaletteRGB(output_buffer,
+      (const uInt8*)screen.getArray(), screen.arraySize(), layout);
+}
+
+void ALEInterface::setObservationPipeline(int height, int width, int stack_size,
+                                          bool max_pool) {
+  if (environment.get() == NULL) {
+    throw std::runtime_error("ROM not set");
+  }
+  environment->setObservationPipeline(height, width, stack_size, max_pool);
+}
+
+void ALEInterface::getObservation(unsigned char* output_buffer) {
+  if (environment.get() == NULL) {
+    throw std::runtime_error("ROM not set");
+  }
+  const ObservationPipeline* pipeline = environment->getObservationPipeline();
+  if (pipeline == NULL) {
+    throw std::runtime_error("No observation pipeline set");
+  }
+  pipeline->getObservation(output_buffer);
+}
+
 // Returns the current RAM content
 const ALERAM& ALEInterface::getRAM() {
   return environment->getRAM();
@@ -381,24 +416,71 @@ ALEState ALEInterface::cloneState() {
   return environment->cloneState();
 }
 
+void ALEInterface::cloneState(ALEState& state) {
+  environment->cloneState(state);
+}
+
 void ALEInterface::restoreState(const ALEState& state) {
   return environment->restoreState(state);
 }
 
+bool ALEInterface::cloneState(ALESnapshot& snapshot) {
+  return environment->cloneState(snapshot);
+}
+
+void ALEInterface::restoreState(const ALESnapshot& snapshot) {
+  environment->restoreState(snapshot);
+}
+
 ALEState ALEInterface::cloneSystemState() {
   return environment->cloneSystemState();
 }
 
+void ALEInterface::cloneSystemState(ALEState& state) {
+  environment->cloneSystemState(state);
+}
+
 void ALEInterface::restoreSystemState(const ALEState& state) {
   return environment->restoreSystemState(state);
 }
 
+void ALEInterface::startRecording() {
+  if (!romSettings.get()) {
+    throw std::runtime_error("ROM not set");
+  }
+
+  uInt32 seed = theOSystem->settings().getInt("random_seed");
+  if (seed == 0) {
+    seed = theOSystem->rng().next();
+  }
+
+  m_trajectory.reset(new Trajectory());
+  m_trajectory->seed = seed;
+  m_trajectory->mode = environment->getState().getCurrentMode();
+  m_trajectory->difficulty = environment->getState().getDifficulty();
+
+  // Start from a state which only depends on the seed, mode and difficulty
+  theOSystem->rng().seed(seed);
+  environment->reset();
+}
+
+Trajectory ALEInterface::stopRecording() {
+  if (m_trajectory.get() == NULL) {
+    throw std::runtime_error("No trajectory is being recorded");
+  }
+  Trajectory trajectory = *m_trajectory;
+  m_trajectory.reset();
+  return trajectory;
+}
+
 void ALEInterface::saveScreenPNG(const std::string& filename) {
-  ScreenExporter exporter(theOSystem->colourPalette());
+  ScreenExporter exporter(theOSystem->colourPalette(),
+                          theOSystem->settings().getInt("record_screen_compression"));
   exporter.save(environment->getScreen(), filename);
 }
 
 ScreenExporter *ALEInterface::createScreenExporter(
     const std::string &filename) const {
-  return new ScreenExporter(theOSystem->colourPalette(), filename);
+  return new ScreenExporter(theOSystem->colourPalette(), filename,
+                            theOSystem->settings().getInt("record_screen_compression"));
 }
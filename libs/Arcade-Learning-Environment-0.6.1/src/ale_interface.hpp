@@ -39,8 +39,10 @@
 #include "games/Roms.hpp"
 #include "common/display_screen.h"
 #include "environment/stella_environment.hpp"
+#include "environment/state_tree.hpp"
 #include "common/ScreenExporter.hpp"
 #include "common/Log.hpp"
+#include "trajectory.hpp"
 
 #include <string>
 #include <memory>
@@ -143,7 +145,27 @@ public:
   //followed by the green colours and then the blue colours
   void getScreenRGB(std::vector<unsigned char>& output_rgb_buffer);
 
-  // Returns the current RAM content
+  // Same as above, but write into caller-provided buffers of width * height bytes
+  // (grayscale) or 3 * width * height bytes (RGB, in the given layout)
+  void getScreenGrayscale(unsigned char* output_buffer);
+  void getScreenRGB(unsigned char* output_buffer,
+                    ColourPalette::Layout layout = ColourPalette::LAYOUT_HWC);
+
+  // Attaches a preprocessing stage to the environment, which after each act() turns the
+  // screen into a height x width grayscale observation (taking the maximum over the last
+  // two frames when max_pool is set) and keeps the last stack_size of them. A stack size
+  // of 0 detaches it. Must be called after loadROM(), and throws std::runtime_error if
+  // render_mode is 'never', color_averaging is set, height or width is
+  // not positive or stack_size is negative.
+  void setObservationPipeline(int height = 84, int width = 84, int stack_size = 4,
+                              bool max_pool = true);
+
+  // Copies the stacked observations, oldest first, into a caller-provided buffer of
+  // stack_size * height * width bytes
+  void getObservation(unsigned char* output_buffer);
+
+  // Returns a read-only view over the RAM. The view always reflects the current
+  // RAM content; use ALERAM::snapshot() to keep a copy.
   const ALERAM &getRAM();
 
   // Saves the state of the system
@@ -156,18 +178,43 @@ public:
   // making it suitable for planning purposes. By contrast, see cloneSystemState.
   ALEState cloneState();
 
+  // Same as cloneState(), but stores the copy into 'state'. The memory held by 'state' is
+  // reused, so cloning repeatedly into the same object does not allocate.
+  void cloneState(ALEState& state);
+
   // Reverse operation of cloneState(). This does not restore pseudorandomness, so that repeated
   // calls to restoreState() in the stochastic controls setting will not lead to the same outcomes.
   // By contrast, see restoreSystemState.
   void restoreState(const ALEState& state);
 
+  // Copies the environment state into a fixed-size snapshot, which is much cheaper than
+  // cloneState() and can be copied with memcpy. Returns false if the game's cartridge type
+  // keeps state which does not fit in a snapshot; cloneState() must then be used instead.
+  // Like cloneState(), this does not include pseudorandomness.
+  bool cloneState(ALESnapshot& snapshot);
+
+  // Reverse operation of cloneState(ALESnapshot&).
+  void restoreState(const ALESnapshot& snapshot);
+
   // This makes a copy of the system & environment state, suitable for serialization. This includes
   // pseudorandomness and so is *not* suitable for planning purposes.
   ALEState cloneSystemState();
 
+  // Same as cloneSystemState(), but stores the copy into 'state', reusing its memory.
+  void cloneSystemState(ALEState& state);
+
   // Reverse operation of cloneSystemState.
   void restoreSystemState(const ALEState& state);
 
+  // Starts recording a trajectory (see trajectory.hpp). The random number generator is
+  // reseeded and the game reset, so that the trajectory only depends on the seed, mode and
+  // difficulty; calls to act() and reset_game() are then recorded until stopRecording().
+  // With random_seed set to 0, a seed is drawn from the current generator.
+  void startRecording();
+
+  // Stops recording and returns the trajectory recorded since startRecording().
+  Trajectory stopRecording();
+
   // Save the current screen as a png file
   void saveScreenPNG(const std::string& filename);
 
@@ -194,6 +241,9 @@ public:
 
  private:
   static void checkForUnsupportedRom(std::unique_ptr<OSystem>& theOSystem);
+
+  // Trajectory being recorded, or NULL
+  std::unique_ptr<Trajectory> m_trajectory;
 };
 
 #endif
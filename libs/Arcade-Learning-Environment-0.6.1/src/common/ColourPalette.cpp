@@ -21,6 +21,11 @@
 #include <fstream>
 #include "Palettes.hpp"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ALE_PALETTE_AVX2
+#include <immintrin.h>
+#endif
+
 using namespace std;
 
 inline uInt32 packRGB(uInt8 r, uInt8 g, uInt8 b)
@@ -42,6 +47,159 @@ inline uInt32 convertGrayscale(uInt32 packedRGBValue)
 ColourPalette::ColourPalette(): m_palette(NULL) {
 }
 
+/**
+    Palette lookup kernels. Colours sit at even palette entries, each followed by its
+    grayscale version; odd (grayscale) screen values map onto themselves.
+
+    The AVX2 kernels gather eight palette entries at a time. They are compiled for AVX2
+    through target attributes and only picked when the CPU supports it, so the library
+    itself still runs on any x86 CPU.
+ */
+namespace {
+
+struct PaletteKernels {
+    void (*grayscale)(const uInt32* palette, uInt8* dst, const uInt8* src, size_t n);
+    void (*rgb)(const uInt32* palette, uInt8* dst, const uInt8* src, size_t n);
+    void (*planes)(const uInt32* palette, uInt8* red, uInt8* green, uInt8* blue,
+                   const uInt8* src, size_t n);
+};
+
+void grayscaleScalar(const uInt32* palette, uInt8* dst, const uInt8* src, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        dst[i] = (uInt8)(palette[src[i] | 1] & 0xFF);
+}
+
+void rgbScalar(const uInt32* palette, uInt8* dst, const uInt8* src, size_t n)
+{
+    for (size_t i = 0; i < n; i++, dst += 3) {
+        uInt32 rgb = palette[src[i]];
+        dst[0] = (uInt8)(rgb >> 16);    // r
+        dst[1] = (uInt8)(rgb >>  8);    // g
+        dst[2] = (uInt8)(rgb >>  0);    // b
+    }
+}
+
+void planesScalar(const uInt32* palette, uInt8* red, uInt8* green, uInt8* blue,
+                  const uInt8* src, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        uInt32 rgb = palette[src[i]];
+        red[i]   = (uInt8)(rgb >> 16);
+        green[i] = (uInt8)(rgb >>  8);
+        blue[i]  = (uInt8)(rgb >>  0);
+    }
+}
+
+#ifdef ALE_PALETTE_AVX2
+// Looks up the palette entries of 8 screen values
+__attribute__((target("avx2")))
+inline __m256i gather8(const uInt32* palette, const uInt8* src, __m256i index_bits)
+{
+    __m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)src));
+    return _mm256_i32gather_epi32((const int*)palette, _mm256_or_si256(index, index_bits), 4);
+}
+
+// Packs the low bytes of 32 dwords, 8 from each argument, into 32 consecutive bytes
+__attribute__((target("avx2")))
+inline __m256i packBytes(__m256i a, __m256i b, __m256i c, __m256i d)
+{
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    __m256i bytes = _mm256_packus_epi16(_mm256_packus_epi32(a, b), _mm256_packus_epi32(c, d));
+    return _mm256_permutevar8x32_epi32(bytes, order);
+}
+
+__attribute__((target("avx2")))
+void grayscaleAVX2(const uInt32* palette, uInt8* dst, const uInt8* src, size_t n)
+{
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i a = _mm256_and_si256(gather8(palette, src + i, one), mask);
+        __m256i b = _mm256_and_si256(gather8(palette, src + i + 8, one), mask);
+        __m256i c = _mm256_and_si256(gather8(palette, src + i + 16, one), mask);
+        __m256i d = _mm256_and_si256(gather8(palette, src + i + 24, one), mask);
+        _mm256_storeu_si256((__m256i*)(dst + i), packBytes(a, b, c, d));
+    }
+    grayscaleScalar(palette, dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx2")))
+void rgbAVX2(const uInt32* palette, uInt8* dst, const uInt8* src, size_t n)
+{
+    // Turns each 0x00RRGGBB dword into R, G, B and packs them in the low 12 bytes of each lane
+    const __m256i shuffle = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i zero = _mm256_setzero_si256();
+
+    // Each step writes 28 bytes for 8 pixels; the extra 4 bytes are overwritten by the
+    // next pixels, so stop while at least 10 pixels are left
+    size_t i = 0;
+    for (; i + 10 <= n; i += 8, dst += 24) {
+        __m256i rgb = _mm256_shuffle_epi8(gather8(palette, src + i, zero), shuffle);
+        _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(rgb));
+        _mm_storeu_si128((__m128i*)(dst + 12), _mm256_extracti128_si256(rgb, 1));
+    }
+    rgbScalar(palette, dst, src + i, n - i);
+}
+
+__attribute__((target("avx2")))
+void planesAVX2(const uInt32* palette, uInt8* red, uInt8* green, uInt8* blue,
+                const uInt8* src, size_t n)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i a = gather8(palette, src + i, zero);
+        __m256i b = gather8(palette, src + i + 8, zero);
+        __m256i c = gather8(palette, src + i + 16, zero);
+        __m256i d = gather8(palette, src + i + 24, zero);
+
+        _mm256_storeu_si256((__m256i*)(red + i), packBytes(
+            _mm256_and_si256(_mm256_srli_epi32(a, 16), mask),
+            _mm256_and_si256(_mm256_srli_epi32(b, 16), mask),
+            _mm256_and_si256(_mm256_srli_epi32(c, 16), mask),
+            _mm256_and_si256(_mm256_srli_epi32(d, 16), mask)));
+        _mm256_storeu_si256((__m256i*)(green + i), packBytes(
+            _mm256_and_si256(_mm256_srli_epi32(a, 8), mask),
+            _mm256_and_si256(_mm256_srli_epi32(b, 8), mask),
+            _mm256_and_si256(_mm256_srli_epi32(c, 8), mask),
+            _mm256_and_si256(_mm256_srli_epi32(d, 8), mask)));
+        _mm256_storeu_si256((__m256i*)(blue + i), packBytes(
+            _mm256_and_si256(a, mask), _mm256_and_si256(b, mask),
+            _mm256_and_si256(c, mask), _mm256_and_si256(d, mask)));
+    }
+    planesScalar(palette, red + i, green + i, blue + i, src + i, n - i);
+}
+#endif // ALE_PALETTE_AVX2
+
+PaletteKernels selectPaletteKernels()
+{
+    PaletteKernels kernels = { grayscaleScalar, rgbScalar, planesScalar };
+#ifdef ALE_PALETTE_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.grayscale = grayscaleAVX2;
+        kernels.rgb = rgbAVX2;
+        kernels.planes = planesAVX2;
+    }
+#endif
+    return kernels;
+}
+
+const PaletteKernels& paletteKernels()
+{
+    static const PaletteKernels kernels = selectPaletteKernels();
+    return kernels;
+}
+
+} // namespace
+
 
 void ColourPalette::getRGB(int val, int &r, int &g, int &b) const
 {
@@ -73,15 +231,7 @@ uInt32 ColourPalette::getRGB(int val) const
 
 void ColourPalette::applyPaletteRGB(uInt8* dst_buffer, uInt8 *src_buffer, size_t src_size)
 {
-    uInt8 *p = src_buffer;
-    uInt8 *q = dst_buffer;
-
-    for(size_t i = 0; i < src_size; i++, p++){
-        int rgb = m_palette[*p];
-        *q = (unsigned char) ((rgb >> 16));  q++;    // r
-        *q = (unsigned char) ((rgb >>  8));  q++;    // g
-        *q = (unsigned char) ((rgb >>  0));  q++;    // b
-    }
+    applyPaletteRGB(dst_buffer, src_buffer, src_size, LAYOUT_HWC);
 }
 
 void ColourPalette::applyPaletteRGB(std::vector<unsigned char>& dst_buffer, uInt8 *src_buffer, size_t src_size)
@@ -89,24 +239,28 @@ void ColourPalette::applyPaletteRGB(std::vector<unsigned char>& dst_buffer, uInt
     dst_buffer.resize(3 * src_size);
     assert(dst_buffer.size() == 3 * src_size);
 
-    uInt8 *p = src_buffer;
+    applyPaletteRGB(&dst_buffer[0], src_buffer, src_size, LAYOUT_HWC);
+}
 
-    for(size_t i = 0; i < src_size * 3; i += 3, p++){
-        int rgb = m_palette[*p];
-        dst_buffer[i+0] = (unsigned char) ((rgb >> 16));    // r
-        dst_buffer[i+1] = (unsigned char) ((rgb >>  8));    // g
-        dst_buffer[i+2] = (unsigned char) ((rgb >>  0));    // b
-    }
+void ColourPalette::applyPaletteRGB(uInt8* dst_buffer, const uInt8 *src_buffer, size_t src_size,
+                                    Layout layout) const
+{
+    if (layout == LAYOUT_CHW)
+        applyPaletteRGB(dst_buffer, dst_buffer + src_size, dst_buffer + 2 * src_size,
+                        src_buffer, src_size);
+    else
+        paletteKernels().rgb(m_palette, dst_buffer, src_buffer, src_size);
 }
 
-void ColourPalette::applyPaletteGrayscale(uInt8* dst_buffer, uInt8 *src_buffer, size_t src_size)
+void ColourPalette::applyPaletteRGB(uInt8* red_buffer, uInt8* green_buffer, uInt8* blue_buffer,
+                                    const uInt8 *src_buffer, size_t src_size) const
 {
-    uInt8 *p = src_buffer;
-    uInt8 *q = dst_buffer;
+    paletteKernels().planes(m_palette, red_buffer, green_buffer, blue_buffer, src_buffer, src_size);
+}
 
-    for(size_t i = 0; i < src_size; i++, p++, q++){
-        *q = (unsigned char) (m_palette[*p+1] & 0xFF);
-    }
+void ColourPalette::applyPaletteGrayscale(uInt8* dst_buffer, uInt8 *src_buffer, size_t src_size)
+{
+    applyPaletteGrayscale(dst_buffer, (const uInt8*)src_buffer, src_size);
 }
 
 void ColourPalette::applyPaletteGrayscale(std::vector<unsigned char>& dst_buffer, uInt8 *src_buffer, size_t src_size)
@@ -114,11 +268,12 @@ void ColourPalette::applyPaletteGrayscale(std::vector<unsigned char>& dst_buffer
     dst_buffer.resize(src_size);
     assert(dst_buffer.size() == src_size);
 
-    uInt8 *p = src_buffer;
+    applyPaletteGrayscale(&dst_buffer[0], (const uInt8*)src_buffer, src_size);
+}
 
-    for(size_t i = 0; i < src_size; i++, p++){
-        dst_buffer[i] = (unsigned char) (m_palette[*p+1] & 0xFF);
-    }
+void ColourPalette::applyPaletteGrayscale(uInt8* dst_buffer, const uInt8 *src_buffer, size_t src_size) const
+{
+    paletteKernels().grayscale(m_palette, dst_buffer, src_buffer, src_size);
 }
 
 void ColourPalette::setPalette(const string& type,
@@ -36,6 +36,12 @@ class ColourPalette {
         /** Returns the byte-sized grayscale value for this palette index. */ 
         uInt8 getGrayscale(int val) const; 
 
+        /** Memory layouts of RGB screens */
+        enum Layout {
+            LAYOUT_HWC, // Interleaved, RGBRGB... per pixel
+            LAYOUT_CHW  // Planar, all red values, then all green values, then all blue values
+        };
+
         /**
             Applies the current RGB palette to the src_buffer and returns the results in dst_buffer
             For each byte in src_buffer, three bytes are returned in dst_buffer
@@ -43,6 +49,12 @@ class ColourPalette {
          */
         void applyPaletteRGB(uInt8* dst_buffer, uInt8 *src_buffer, size_t src_size);
         void applyPaletteRGB(std::vector<unsigned char>& dst_buffer, uInt8 *src_buffer, size_t src_size);
+        /** Same as above, writing the 3 * src_size bytes in the given layout. */
+        void applyPaletteRGB(uInt8* dst_buffer, const uInt8 *src_buffer, size_t src_size,
+                             Layout layout) const;
+        /** Same as above, writing each colour component into its own plane of src_size bytes. */
+        void applyPaletteRGB(uInt8* red_buffer, uInt8* green_buffer, uInt8* blue_buffer,
+                             const uInt8 *src_buffer, size_t src_size) const;
 
         /**
             Applies the current grayscale palette to the src_buffer and returns the results in dst_buffer
@@ -51,6 +63,7 @@ class ColourPalette {
          */
         void applyPaletteGrayscale(uInt8* dst_buffer, uInt8 *src_buffer, size_t src_size);
         void applyPaletteGrayscale(std::vector<unsigned char>& dst_buffer, uInt8 *src_buffer, size_t src_size);
+        void applyPaletteGrayscale(uInt8* dst_buffer, const uInt8 *src_buffer, size_t src_size) const;
 
         /**
           Loads all defined palettes with PAL color-loss data depending
@@ -0,0 +1,314 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  EpisodeFile.cpp
+ *
+ *  A single-file container for recorded episodes.
+ *
+ **************************************************************************** */
+
+#include "EpisodeFile.hpp"
+#include <cstring>
+#include "ColourPalette.hpp"
+#include "Log.hpp"
+
+static const char EPISODE_MAGIC[8] = { 'A', 'L', 'E', 'E', 'P', 'I', 'S', '1' };
+static const char INDEX_MAGIC[8] = { 'A', 'L', 'E', 'I', 'N', 'D', 'E', 'X' };
+static const uInt32 EPISODE_VERSION = 1;
+
+static const int HEADER_SIZE = 20;
+static const int INDEX_ENTRY_SIZE = 16;
+static const int FOOTER_SIZE = 20;
+
+// Runs of at least this many equal bytes are stored as (count, value) pairs
+static const int MIN_RUN = 3;
+static const int MAX_RUN = 127 + MIN_RUN;
+static const int MAX_LITERAL = 128;
+
+static void putU16(uInt8 *p, uInt32 v) {
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+}
+
+static void putU32(uInt8 *p, uInt32 v) {
+    for (int i = 0; i < 4; i++) p[i] = (v >> (8 * i)) & 0xFF;
+}
+
+static void putU64(uInt8 *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (v >> (8 * i)) & 0xFF;
+}
+
+static uInt32 getU16(const uInt8 *p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uInt32 getU32(const uInt8 *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uInt32)p[3] << 24);
+}
+
+static uint64_t getU64(const uInt8 *p) {
+    return getU32(p) | ((uint64_t)getU32(p + 4) << 32);
+}
+
+// Control byte c < 0x80: c + 1 literal bytes follow. Otherwise the next byte
+// repeats (c & 0x7F) + MIN_RUN times. XOR deltas are mostly long zero runs.
+static void encodeRLE(const pixel_t *src, size_t n, std::vector<uInt8> &out) {
+
+    out.clear();
+    size_t i = 0;
+    while (i < n) {
+        // Length of the run starting here
+        size_t run = 1;
+        while (i + run < n && run < (size_t)MAX_RUN && src[i + run] == src[i]) run++;
+
+        if (run >= (size_t)MIN_RUN) {
+            out.push_back(0x80 | (uInt8)(run - MIN_RUN));
+            out.push_back(src[i]);
+            i += run;
+            continue;
+        }
+
+        // Literal bytes, up to the start of the next run
+        size_t start = i;
+        while (i < n && i - start < (size_t)MAX_LITERAL) {
+            if (i + MIN_RUN <= n && src[i] == src[i + 1] && src[i] == src[i + 2]) break;
+            i++;
+        }
+        out.push_back((uInt8)(i - start - 1));
+        out.insert(out.end(), src + start, src + i);
+    }
+}
+
+// Decodes into dst, either replacing its bytes (keyframes) or XORing them
+// (deltas). Returns false if the data does not describe exactly n bytes.
+static bool decodeRLE(const uInt8 *src, size_t size, pixel_t *dst, size_t n, bool xorMode) {
+
+    const uInt8 *end = src + size;
+    size_t i = 0;
+    while (src < end) {
+        uInt8 control = *src++;
+        if (control & 0x80) {
+            size_t run = (control & 0x7F) + MIN_RUN;
+            if (src >= end || i + run > n) return false;
+            uInt8 value = *src++;
+            if (!xorMode) {
+                memset(dst + i, value, run);
+            } else if (value != 0) {
+                for (size_t k = 0; k < run; k++) dst[i + k] ^= value;
+            }
+            i += run;
+        } else {
+            size_t count = control + 1;
+            if ((size_t)(end - src) < count || i + count > n) return false;
+            if (!xorMode) {
+                memcpy(dst + i, src, count);
+            } else {
+                for (size_t k = 0; k < count; k++) dst[i + k] ^= src[k];
+            }
+            src += count;
+            i += count;
+        }
+    }
+    return i == n;
+}
+
+
+EpisodeWriter::EpisodeWriter(const std::string &filename, const ColourPalette &palette,
+                             int width, int height, int keyframe_interval):
+    m_out(filename.c_str(), std::ios_base::binary),
+    m_width(width),
+    m_height(height),
+    m_keyframe_interval(keyframe_interval > 0 ? keyframe_interval : 1),
+    m_previous(width * height),
+    m_delta(width * height) {
+
+    if (!m_out.good()) {
+        m_out.close();
+        return;
+    }
+
+    uInt8 header[HEADER_SIZE];
+    memcpy(header, EPISODE_MAGIC, 8);
+    putU32(header + 8, EPISODE_VERSION);
+    putU16(header + 12, width);
+    putU16(header + 14, height);
+    putU32(header + 16, m_keyframe_interval);
+    m_out.write((const char*)header, sizeof(header));
+
+    // The palette is stored once, so frames only hold indices
+    uInt8 plte[256 * 3];
+    for (int i = 0; i < 256; i++) {
+        uInt32 rgb = palette.getRGB(i);
+        plte[i * 3 + 0] = (rgb >> 16) & 0xFF;
+        plte[i * 3 + 1] = (rgb >>  8) & 0xFF;
+        plte[i * 3 + 2] = (rgb >>  0) & 0xFF;
+    }
+    m_out.write((const char*)plte, sizeof(plte));
+}
+
+EpisodeWriter::~EpisodeWriter() {
+    close();
+}
+
+void EpisodeWriter::append(const pixel_t *pixels) {
+
+    if (!m_out.is_open()) return;
+
+    size_t n = m_previous.size();
+    bool keyframe = m_index.size() % m_keyframe_interval == 0;
+    if (keyframe) {
+        encodeRLE(pixels, n, m_encoded);
+    } else {
+        for (size_t i = 0; i < n; i++) m_delta[i] = pixels[i] ^ m_previous[i];
+        encodeRLE(&m_delta[0], n, m_encoded);
+    }
+    memcpy(&m_previous[0], pixels, n);
+
+    EpisodeIndexEntry entry;
+    entry.offset = (uint64_t)m_out.tellp();
+    entry.size = m_encoded.size();
+    entry.keyframe = keyframe;
+    m_index.push_back(entry);
+
+    m_out.write((const char*)&m_encoded[0], m_encoded.size());
+}
+
+void EpisodeWriter::close() {
+
+    if (!m_out.is_open()) return;
+
+    uint64_t indexOffset = (uint64_t)m_out.tellp();
+    std::vector<uInt8> index(m_index.size() * INDEX_ENTRY_SIZE);
+    for (size_t i = 0; i < m_index.size(); i++) {
+        uInt8 *p = &index[i * INDEX_ENTRY_SIZE];
+        putU64(p, m_index[i].offset);
+        putU32(p + 8, m_index[i].size);
+        putU32(p + 12, m_index[i].keyframe);
+    }
+    if (!index.empty()) m_out.write((const char*)&index[0], index.size());
+
+    uInt8 footer[FOOTER_SIZE];
+    putU64(footer, indexOffset);
+    putU32(footer + 8, m_index.size());
+    memcpy(footer + 12, INDEX_MAGIC, 8);
+    m_out.write((const char*)footer, sizeof(footer));
+
+    if (!m_out.good()) {
+        ale::Logger::Error << "Error: Couldn't write the episode index" << std::endl;
+    }
+    m_out.close();
+}
+
+
+EpisodeReader::EpisodeReader():
+    m_width(0),
+    m_height(0),
+    m_current_frame(0),
+    m_has_current(false) {
+    memset(m_palette, 0, sizeof(m_palette));
+}
+
+bool EpisodeReader::open(const std::string &filename) {
+
+    m_in.close();
+    m_in.clear();
+    m_index.clear();
+    m_has_current = false;
+
+    m_in.open(filename.c_str(), std::ios_base::binary);
+    if (!m_in.good()) return false;
+
+    uInt8 header[HEADER_SIZE];
+    if (!m_in.read((char*)header, sizeof(header)) || memcmp(header, EPISODE_MAGIC, 8) != 0 ||
+        getU32(header + 8) != EPISODE_VERSION) {
+        return false;
+    }
+    m_width = getU16(header + 12);
+    m_height = getU16(header + 14);
+    if (!m_in.read((char*)m_palette, sizeof(m_palette))) return false;
+
+    // The footer tells where the index starts
+    uInt8 footer[FOOTER_SIZE];
+    m_in.seekg(-FOOTER_SIZE, std::ios_base::end);
+    uint64_t footerOffset = (uint64_t)m_in.tellg();
+    if (!m_in.read((char*)footer, sizeof(footer)) || memcmp(footer + 12, INDEX_MAGIC, 8) != 0) {
+        return false;
+    }
+    uint64_t indexOffset = getU64(footer);
+    size_t numFrames = getU32(footer + 8);
+    if (indexOffset + (uint64_t)numFrames * INDEX_ENTRY_SIZE != footerOffset) return false;
+
+    std::vector<uInt8> index(numFrames * INDEX_ENTRY_SIZE);
+    m_in.seekg(indexOffset);
+    if (numFrames > 0 && !m_in.read((char*)&index[0], index.size())) return false;
+
+    m_index.resize(numFrames);
+    for (size_t i = 0; i < numFrames; i++) {
+        const uInt8 *p = &index[i * INDEX_ENTRY_SIZE];
+        m_index[i].offset = getU64(p);
+        m_index[i].size = getU32(p + 8);
+        m_index[i].keyframe = getU32(p + 12);
+        if (m_index[i].offset + m_index[i].size > indexOffset) return false;
+    }
+    // Every frame must be reachable from a keyframe
+    if (numFrames > 0 && !m_index[0].keyframe) return false;
+
+    m_current.assign(frameSize(), 0);
+    return true;
+}
+
+bool EpisodeReader::applyFrame(size_t i) {
+
+    const EpisodeIndexEntry &entry = m_index[i];
+    m_encoded.resize(entry.size);
+    m_in.clear();
+    m_in.seekg(entry.offset);
+    if (entry.size > 0 && !m_in.read((char*)&m_encoded[0], entry.size)) return false;
+
+    if (!decodeRLE(m_encoded.empty() ? NULL : &m_encoded[0], entry.size,
+                   &m_current[0], m_current.size(), !entry.keyframe)) {
+        return false;
+    }
+    m_current_frame = i;
+    m_has_current = true;
+    return true;
+}
+
+bool EpisodeReader::decodeFrames(size_t first, size_t count, pixel_t *output) {
+
+    if (count == 0) return true;
+    if (first + count > m_index.size()) return false;
+
+    // Start from the keyframe before the first frame, unless the last decoded
+    // frame lies between that keyframe and the first frame
+    size_t start = first;
+    while (!m_index[start].keyframe) start--;
+    if (m_has_current && m_current_frame >= start && m_current_frame < first) {
+        start = m_current_frame + 1;
+    } else if (m_has_current && m_current_frame == first) {
+        start = first + 1;
+        memcpy(output, &m_current[0], m_current.size());
+        output += m_current.size();
+        first++;
+        count--;
+    }
+
+    for (size_t i = start; i < first + count; i++) {
+        if (!applyFrame(i)) {
+            m_has_current = false;
+            return false;
+        }
+        if (i >= first) {
+            memcpy(output, &m_current[0], m_current.size());
+            output += m_current.size();
+        }
+    }
+    return true;
+}
@@ -0,0 +1,125 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  EpisodeFile.hpp
+ *
+ *  A single-file container for recorded episodes. Screens are stored as
+ *  palette indices: every keyframe_interval frames a keyframe holds the
+ *  run-length encoded screen, and the frames in between hold the
+ *  run-length encoded XOR with the previous screen.
+ *
+ *  Layout (little-endian):
+ *    header    magic "ALEEPIS1", version, width, height, keyframe interval
+ *    palette   256 RGB triplets
+ *    frames    encoded screens, one after the other
+ *    index     one EpisodeIndexEntry per frame
+ *    footer    index offset, number of frames, magic "ALEINDEX"
+ *
+ **************************************************************************** */
+
+#ifndef __EPISODE_FILE_HPP__
+#define __EPISODE_FILE_HPP__
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../emucore/m6502/src/bspf/src/bspf.hxx"
+#include "../environment/ale_screen.hpp"
+
+class ColourPalette;
+
+/** Where a frame lives in the file. */
+struct EpisodeIndexEntry {
+    uint64_t offset;
+    uInt32 size;
+    uInt32 keyframe;
+};
+
+class EpisodeWriter {
+
+    public:
+
+        /** Creates the file and writes the header and palette. Frames must all have
+            the given dimensions. Check isOpen() for errors. */
+        EpisodeWriter(const std::string &filename, const ColourPalette &palette,
+                      int width, int height, int keyframe_interval = 256);
+
+        /** Writes the index, if close() was not called. */
+        ~EpisodeWriter();
+
+        bool isOpen() const { return m_out.is_open(); }
+
+        /** Appends a screen of width x height palette indices. */
+        void append(const pixel_t *pixels);
+
+        /** Writes the frame index and footer and closes the file. */
+        void close();
+
+    private:
+
+        std::ofstream m_out;
+        int m_width;
+        int m_height;
+        int m_keyframe_interval;
+
+        /** The previous screen, the XOR delta and the encoded frame. */
+        std::vector<pixel_t> m_previous;
+        std::vector<pixel_t> m_delta;
+        std::vector<uInt8> m_encoded;
+
+        std::vector<EpisodeIndexEntry> m_index;
+};
+
+class EpisodeReader {
+
+    public:
+
+        EpisodeReader();
+
+        /** Reads the header, palette and frame index. Returns false if the file
+            cannot be read or is not a complete episode. */
+        bool open(const std::string &filename);
+
+        size_t numFrames() const { return m_index.size(); }
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+        size_t frameSize() const { return m_width * m_height; }
+
+        /** The 256 RGB triplets of the recording's palette. */
+        const uInt8 *palette() const { return m_palette; }
+
+        /** Decodes frames [first, first + count) into output, which must hold
+            count * frameSize() bytes. Decoding starts from the nearest keyframe,
+            or continues from the last decoded frame when that is closer. */
+        bool decodeFrames(size_t first, size_t count, pixel_t *output);
+
+        /** Decodes a single frame. */
+        bool decodeFrame(size_t frame, pixel_t *output) { return decodeFrames(frame, 1, output); }
+
+    private:
+
+        /** Applies frame i on top of m_current. */
+        bool applyFrame(size_t i);
+
+        std::ifstream m_in;
+        int m_width;
+        int m_height;
+        uInt8 m_palette[256 * 3];
+        std::vector<EpisodeIndexEntry> m_index;
+
+        /** The last decoded screen (frame m_current_frame), or none if m_has_current is false. */
+        std::vector<pixel_t> m_current;
+        size_t m_current_frame;
+        bool m_has_current;
+        std::vector<uInt8> m_encoded;
+};
+
+#endif // __EPISODE_FILE_HPP__
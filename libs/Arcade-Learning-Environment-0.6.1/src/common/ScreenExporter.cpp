@@ -18,6 +18,9 @@
 #include <zlib.h>
 #include <sstream>
 #include <fstream>
+#include <iomanip>
+#include <cstring>
+#include "EpisodeFile.hpp"
 #include "Log.hpp"
 
 // MGB: These methods originally belonged to ExportScreen. Possibly these should be returned to 
@@ -56,10 +59,8 @@ static void writePNGChunk(std::ofstream& out, const char* type, uInt8* data, int
 }
 
 
-static void writePNGHeader(std::ofstream& out, const ALEScreen &screen, bool doubleWidth = true) {
+static void writePNGHeader(std::ofstream& out, int width, int height) {
 
-        int width = doubleWidth ? screen.width() * 2: screen.width();
-        int height = screen.height();
         // PNG file header
         uInt8 header[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
         out.write((const char*)header, sizeof(header));
@@ -74,8 +75,8 @@ static void writePNGHeader(std::ofstream& out, const ALEScreen &screen, bool dou
         ihdr[5]  = (height >> 16) & 0xFF;
         ihdr[6]  = (height >>  8) & 0xFF;
         ihdr[7]  = (height >>  0) & 0xFF;
-        ihdr[8]  = 8;  // 8 bits per sample (24 bits per pixel)
-        ihdr[9]  = 2;  // PNG_COLOR_TYPE_RGB
+        ihdr[8]  = 8;  // 8 bits per palette index
+        ihdr[9]  = 3;  // PNG_COLOR_TYPE_PALETTE
         ihdr[10] = 0;  // PNG_COMPRESSION_TYPE_DEFAULT
         ihdr[11] = 0;  // PNG_FILTER_TYPE_DEFAULT
         ihdr[12] = 0;  // PNG_INTERLACE_NONE
@@ -83,50 +84,50 @@ static void writePNGHeader(std::ofstream& out, const ALEScreen &screen, bool dou
 }
 
 
-static void writePNGData(std::ofstream &out, const ALEScreen &screen, const ColourPalette &palette, bool doubleWidth = true) {
+static void writePNGPalette(std::ofstream& out, const ColourPalette &palette) {
+
+    // Screens hold palette indices, so the whole palette goes into PLTE
+    uInt8 plte[256 * 3];
+    for (int i = 0; i < 256; i++) {
+        uInt32 rgb = palette.getRGB(i);
+        plte[i * 3 + 0] = (rgb >> 16) & 0xFF;
+        plte[i * 3 + 1] = (rgb >>  8) & 0xFF;
+        plte[i * 3 + 2] = (rgb >>  0) & 0xFF;
+    }
+    writePNGChunk(out, "PLTE", plte, sizeof(plte));
+}
 
-    int dataWidth = screen.width(); 
-    int width = doubleWidth ? dataWidth * 2 : dataWidth; 
-    int height = screen.height();
-   
-    // If so desired, double the width
 
-    // Fill the buffer with scanline data
-    int rowbytes = width * 3;
+static void writePNGData(std::ofstream &out, const pixel_t* pixels, int dataWidth, int height,
+                         int compressionLevel, bool doubleWidth = true) {
 
-    std::vector<uInt8> buffer((rowbytes + 1) * height, 0);
+    int width = doubleWidth ? dataWidth * 2 : dataWidth; 
+
+    // Fill the buffer with scanline data: one palette index per pixel,
+    // doubling the width if so desired
+    int rowbytes = width + 1;
+    std::vector<uInt8> buffer(rowbytes * height);
     uInt8* buf_ptr = &buffer[0];
 
     for(int i = 0; i < height; i++) {
+        const pixel_t* row = pixels + i * dataWidth;
         *buf_ptr++ = 0;                  // first byte of row is filter type
-        for(int j = 0; j < dataWidth; j++) {
-            int r, g, b;
-
-            palette.getRGB(screen.getArray()[i * dataWidth + j], r, g, b);
-            // Double the pixel width, if so desired
-            int jj = doubleWidth ? 2 * j : j;
-
-            buf_ptr[jj * 3 + 0] = r;
-            buf_ptr[jj * 3 + 1] = g;
-            buf_ptr[jj * 3 + 2] = b;
-            
-            if (doubleWidth) {
-                
-                jj = jj + 1;
-
-                buf_ptr[jj * 3 + 0] = r;
-                buf_ptr[jj * 3 + 1] = g;
-                buf_ptr[jj * 3 + 2] = b;
+        if (doubleWidth) {
+            for(int j = 0; j < dataWidth; j++) {
+                buf_ptr[2 * j] = row[j];
+                buf_ptr[2 * j + 1] = row[j];
             }
+        } else {
+            memcpy(buf_ptr, row, dataWidth);
         }
-        buf_ptr += rowbytes;                 // add pitch
+        buf_ptr += width;
     }
 
     // Compress the data with zlib
-    uLongf compmemsize = (uLongf)((height * (width + 1) * 3 + 1) + 12);
-    std::vector<uInt8> compmem(compmemsize, 0);
+    uLongf compmemsize = compressBound(buffer.size());
+    std::vector<uInt8> compmem(compmemsize);
     
-    if((compress(&compmem[0], &compmemsize, &buffer[0], height * (width * 3 + 1)) != Z_OK)) {
+    if (compress2(&compmem[0], &compmemsize, &buffer[0], buffer.size(), compressionLevel) != Z_OK) {
 
         // @todo -- throw a proper exception
         ale::Logger::Error << "Error: Couldn't compress PNG" << std::endl;
@@ -144,38 +145,76 @@ static void writePNGEnd(std::ofstream &out) {
     writePNGChunk(out, "IEND", 0, 0);
 }
 
-ScreenExporter::ScreenExporter(ColourPalette &palette):
+static void writePNG(const std::string &filename, const pixel_t* pixels, int width, int height,
+                     const ColourPalette &palette, int compressionLevel) {
+
+    // Open file for writing 
+    std::ofstream out(filename.c_str(), std::ios_base::binary);
+    if (!out.good()) {
+        
+        // @todo exception
+        ale::Logger::Error << "Could not open " << filename << " for writing" << std::endl;
+        return;
+    }
+
+    // Now write the PNG proper
+    writePNGHeader(out, width * 2, height);
+    writePNGPalette(out, palette);
+    writePNGData(out, pixels, width, height, compressionLevel, true);
+    writePNGEnd(out);
+
+    out.close();
+}
+
+ScreenExporter::ScreenExporter(ColourPalette &palette, int compression_level):
     m_palette(palette),
+    m_compression_level(compression_level),
     m_frame_number(0),
-    m_frame_field_width(6) {
+    m_frame_field_width(6),
+    m_format(FORMAT_PNG),
+    m_queue_size(0),
+    m_encoding(false),
+    m_shutdown(false) {
 }
 
 
-ScreenExporter::ScreenExporter(ColourPalette &palette, const std::string &path):
+ScreenExporter::ScreenExporter(ColourPalette &palette, const std::string &path,
+                               int compression_level, size_t queue_size, Format format):
     m_palette(palette),
+    m_compression_level(compression_level),
     m_frame_number(0),
     m_frame_field_width(6),
-    m_path(path) {
+    m_path(path),
+    m_format(format),
+    m_queue_size(queue_size > 0 ? queue_size : 1),
+    m_encoding(false),
+    m_shutdown(false) {
+
+    m_encoder = std::thread(&ScreenExporter::encoderLoop, this);
 }
 
 
-void ScreenExporter::save(const ALEScreen &screen, const std::string &filename) const {
+ScreenExporter::~ScreenExporter() {
 
-    // Open file for writing 
-    std::ofstream out(filename.c_str(), std::ios_base::binary);
-    if (!out.good()) {
-        
-        // @todo exception
-        ale::Logger::Error << "Could not open " << filename << " for writing" << std::endl;
-        return;
+    if (!m_encoder.joinable()) return;
+
+    // The encoder drains the queue before it stops
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
     }
+    m_work_cv.notify_one();
+    m_encoder.join();
 
-    // Now write the PNG proper
-    writePNGHeader(out, screen, true);
-    writePNGData(out, screen, m_palette, true);
-    writePNGEnd(out);
+    // Writes the episode's frame index
+    m_episode.reset();
+}
 
-    out.close();
+
+void ScreenExporter::save(const ALEScreen &screen, const std::string &filename) const {
+
+    writePNG(filename, screen.getArray(), screen.width(), screen.height(),
+             m_palette, m_compression_level);
 }
 
 void ScreenExporter::saveNext(const ALEScreen &screen) {
@@ -186,15 +225,67 @@ void ScreenExporter::saveNext(const ALEScreen &screen) {
     // MGB: It would be nice here to automagically create paths, but the only way I know of 
     // doing this cleanly is via boost, which we don't include.
 
-    // Construct the filename from basepath & current frame number
-    std::ostringstream oss;
-    oss << m_path << "/" << 
-        std::setw(m_frame_field_width) << std::setfill('0') << m_frame_number << ".png";
+    PendingFrame frame;
+    frame.width = screen.width();
+    frame.height = screen.height();
+    if (m_format == FORMAT_PNG) {
+        // Construct the filename from basepath & current frame number
+        std::ostringstream oss;
+        oss << m_path << "/" << 
+            std::setw(m_frame_field_width) << std::setfill('0') << m_frame_number << ".png";
+        frame.filename = oss.str();
+    }
 
-    // Save the png
-    save(screen, oss.str());
+    // Copy the screen into a recycled buffer, waiting for room in the queue
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_space_cv.wait(lock, [this] { return m_queue.size() < m_queue_size; });
+    if (!m_free_buffers.empty()) {
+        frame.pixels.swap(m_free_buffers.back());
+        m_free_buffers.pop_back();
+    }
+    frame.pixels.assign(screen.getArray(), screen.getArray() + screen.arraySize());
+    m_queue.push_back(std::move(frame));
+    lock.unlock();
+    m_work_cv.notify_one();
 
     m_frame_number++;
 }
 
+void ScreenExporter::flush() {
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_space_cv.wait(lock, [this] { return m_queue.empty() && !m_encoding; });
+}
+
+void ScreenExporter::encoderLoop() {
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_work_cv.wait(lock, [this] { return !m_queue.empty() || m_shutdown; });
+        if (m_queue.empty()) break;
+
+        PendingFrame frame = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_encoding = true;
+        lock.unlock();
+
+        if (m_format == FORMAT_EPISODE) {
+            if (!m_episode) {
+                m_episode.reset(new EpisodeWriter(m_path, m_palette, frame.width, frame.height));
+                if (!m_episode->isOpen()) {
+                    // The following frames are dropped
+                    ale::Logger::Error << "Could not open " << m_path << " for writing" << std::endl;
+                }
+            }
+            m_episode->append(&frame.pixels[0]);
+        } else {
+            writePNG(frame.filename, &frame.pixels[0], frame.width, frame.height,
+                     m_palette, m_compression_level);
+        }
 
+        lock.lock();
+        m_encoding = false;
+        m_free_buffers.push_back(std::move(frame.pixels));
+        m_space_cv.notify_all();
+    }
+}
@@ -12,44 +12,106 @@
  *
  *  A class for exporting Atari 2600 frames as PNGs.
  *
+ *  Frames saved with saveNext() are copied (palette indices only) into a
+ *  bounded queue and encoded by a background thread, so recording costs the
+ *  emulation thread a single screen copy per frame.
+ *
+ *  Frames are written either as one PNG per frame or into a single episode
+ *  file (see EpisodeFile.hpp).
+ *
  **************************************************************************** */
 
 #ifndef __SCREEN_EXPORTER_HPP__
 #define __SCREEN_EXPORTER_HPP__ 
 
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 #include "display_screen.h"
 #include "../environment/ale_screen.hpp"
 
+class EpisodeWriter;
+
 class ScreenExporter {
 
     public:
 
-        /** Creates a new ScreenExporter which can be used to save screens using save(filename). */ 
-        ScreenExporter(ColourPalette &palette);
+        /** Where saveNext() writes frames. */
+        enum Format {
+            FORMAT_PNG,      // one PNG per frame in the given directory
+            FORMAT_EPISODE   // every frame in the given episode file
+        };
+
+        /** Creates a new ScreenExporter which can be used to save screens using save(filename).
+            compression_level is the zlib level (0-9); -1 selects zlib's default. */ 
+        ScreenExporter(ColourPalette &palette, int compression_level = -1);
 
         /** Creates a new ScreenExporter which will save frames successively in the directory provided.
-            Frames are sequentially named with 6 digits, starting at 000000. */
-        ScreenExporter(ColourPalette &palette, const std::string &path);
+            Frames are sequentially named with 6 digits, starting at 000000. With FORMAT_EPISODE,
+            path is instead the episode file that receives every frame. At most queue_size
+            frames wait to be encoded; saveNext() blocks while the queue is full. */
+        ScreenExporter(ColourPalette &palette, const std::string &path,
+                       int compression_level = -1, size_t queue_size = 64,
+                       Format format = FORMAT_PNG);
+
+        /** Waits until every queued frame has been written. */
+        ~ScreenExporter();
 
         /** Save the given screen to the given filename. No paths are created. */
         void save(const ALEScreen &screen, const std::string &filename) const;
 
-        /** Save the given screen according to our own internal numbering. */
+        /** Save the given screen according to our own internal numbering. The screen
+            is written asynchronously; call flush() to wait for it. */
         void saveNext(const ALEScreen &screen);
 
+        /** Blocks until all frames passed to saveNext() have been written. */
+        void flush();
+
     private:
 
+        /** A frame waiting to be encoded. */
+        struct PendingFrame {
+            std::vector<pixel_t> pixels;
+            int width;
+            int height;
+            std::string filename;
+        };
+
+        void encoderLoop();
+
         ColourPalette &m_palette;
 
+        /** zlib compression level used for the image data. */
+        int m_compression_level;
+
         /** The next frame number. */
         int m_frame_number;
 
         /** The width of the frame number when constructing filenames (set to 6). */
         int m_frame_field_width;
 
-        /** The directory where we save successive frames. */ 
+        /** The directory (or episode file) where we save successive frames. */ 
         std::string m_path;
+
+        Format m_format;
+
+        /** The episode file, created by the encoder thread on the first frame. */
+        std::unique_ptr<EpisodeWriter> m_episode;
+
+        /** Encoder thread state; the queue holds at most m_queue_size frames. */
+        size_t m_queue_size;
+        std::deque<PendingFrame> m_queue;
+        std::vector<std::vector<pixel_t> > m_free_buffers;
+        bool m_encoding;
+        bool m_shutdown;
+        std::mutex m_mutex;
+        std::condition_variable m_work_cv;
+        std::condition_variable m_space_cv;
+        std::thread m_encoder;
 };
 
 #endif // __SCREEN_EXPORTER_HPP__ 
@@ -1,5 +1,6 @@
 #include "SoundExporter.hpp"
 #include <cassert>
+#include "Log.hpp"
 
 namespace ale {
 namespace sound {
@@ -7,20 +8,43 @@ namespace sound {
 // Sample rate is 60Hz x SamplesPerFrame bytes
 // TODO(mgb): in reality this should be 31,400 Hz, but currently we are just short of this
 static const unsigned int SampleRate = 60 * SoundExporter::SamplesPerFrame; 
-// Save wav file every 30 seconds
-static const unsigned int WriteInterval = SampleRate * 30;
+// Hand samples to the writer thread every second of audio
+static const unsigned int WriteInterval = SampleRate;
+
+// Offsets of the sizes patched after every write, and size of the header
+static const int RiffSizeOffset = 4;
+static const int DataSizeOffset = 40;
+static const int HeaderSize = 44;
 
 
 SoundExporter::SoundExporter(const std::string &filename, int channels):
     m_filename(filename),
+    m_stream(filename.c_str(), std::ios::binary),
     m_channels(channels),
-    m_samples_since_write(0) {
+    m_data_size(0),
+    m_shutdown(false) {
+
+    if (!m_stream.good()) {
+        ale::Logger::Error << "Could not open " << filename << " for writing" << std::endl;
+        return;
+    }
+
+    writeWAVHeader();
+    m_writer = std::thread(&SoundExporter::writerLoop, this);
 }
 
 
 SoundExporter::~SoundExporter() {
 
-    writeWAVData();
+    if (!m_writer.joinable()) return;
+
+    // The writer flushes the remaining samples before it stops
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_cv.notify_one();
+    m_writer.join();
 }
 
 
@@ -29,31 +53,50 @@ void SoundExporter::addSamples(SampleType *s, int len) {
     // @todo -- currently we only support mono recording 
     assert(m_channels == 1);
 
-    for (int i = 0; i < len; i++)
-        m_data.push_back(s[i]);
+    // Without a file (the constructor logged why) the samples are dropped
+    if (!m_writer.joinable()) return;
+
+    bool notify;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.insert(m_pending.end(), s, s + len);
+        notify = m_pending.size() >= WriteInterval;
+    }
 
     // Periodically flush to disk (to avoid cases where the destructor is not called)
-    m_samples_since_write += len;
-    if (m_samples_since_write >= WriteInterval) {
+    if (notify) m_cv.notify_one();
+}
+
+
+void SoundExporter::writerLoop() {
+
+    // Samples are swapped out of m_pending, so addSamples never waits on the disk
+    std::vector<SampleType> samples;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_cv.wait(lock, [this] { return m_pending.size() >= WriteInterval || m_shutdown; });
+        bool done = m_shutdown;
+        samples.swap(m_pending);
+        lock.unlock();
 
-        writeWAVData();
-        m_samples_since_write = 0;
+        writeWAVData(samples);
+        samples.clear();
+
+        lock.lock();
+        if (done) break;
     }
 }
 
 
-void SoundExporter::writeWAVData() {
+void SoundExporter::writeWAVHeader() {
    
     // Taken from http://stackoverflow.com/questions/22226872/two-problems-when-writing-to-wav-c
-    // Open file stream 
-    std::ofstream stream(m_filename.c_str(), std::ios::binary);                
-
-    // Cast size into a 32-bit integer
-    int bufSize = m_data.size();
+    // The RIFF and data sizes are patched by writeWAVData()
+    std::ofstream &stream = m_stream;
 
     // Header 
     stream.write("RIFF", 4);                                        // sGroupID (RIFF = Resource Interchange File Format)
-    write<int>(stream, 36 + bufSize);                               // dwFileLength
+    write<int>(stream, 36);                                         // dwFileLength
     stream.write("WAVE", 4);                                        // sRiffType
 
     // Format chunk
@@ -68,10 +111,35 @@ void SoundExporter::writeWAVData() {
 
     // Data chunk
     stream.write("data", 4);                                        // sGroupID (data)
-    stream.write((const char*)&bufSize, 4);                         // Chunk size (of Data, and thus of bufferSize)
-    stream.write((const char*)&m_data[0], bufSize);                 // The samples DATA!!!
+    write<int>(stream, 0);                                          // Chunk size (of Data, and thus of bufferSize)
+    stream.flush();
+}
+
+
+void SoundExporter::writeWAVData(const std::vector<SampleType> &samples) {
+
+    // After a write error (already logged) the samples are dropped
+    if (!m_stream.good()) return;
+
+    // Append the new samples
+    if (!samples.empty()) {
+        m_stream.write((const char*)&samples[0], samples.size() * sizeof(SampleType));
+        m_data_size += samples.size() * sizeof(SampleType);
+    }
+
+    // Cast size into a 32-bit integer and patch the sizes in place
+    int bufSize = m_data_size;
+    m_stream.seekp(RiffSizeOffset);
+    write<int>(m_stream, 36 + bufSize);
+    m_stream.seekp(DataSizeOffset);
+    write<int>(m_stream, bufSize);
+    m_stream.seekp(HeaderSize + m_data_size);
+    m_stream.flush();
+
+    if (!m_stream.good()) {
+        ale::Logger::Error << "Error: Couldn't write " << m_filename << std::endl;
+    }
 }
 
 } // namespace ale::sound 
 } // namespace ale
-
@@ -13,6 +13,10 @@
  *
  *  A class for writing Atari 2600 sound to a WAV file.
  *
+ *  Samples are streamed to disk by a background thread: new samples are
+ *  appended to the file and the RIFF/data sizes patched in place, so the
+ *  cost of recording does not grow with the length of the session.
+ *
  *  Parts of this code were taken from 
  *
  *  http://stackoverflow.com/questions/22226872/two-problems-when-writing-to-wav-c
@@ -22,7 +26,11 @@
 #ifndef __SOUND_EXPORTER_HPP__
 #define __SOUND_EXPORTER_HPP__ 
 
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 #include "../emucore/m6502/src/bspf/src/bspf.hxx"
 
@@ -42,29 +50,42 @@ class SoundExporter {
 
         typedef uInt8 SampleType;
   
-        /** Create a new sound exporter which, on program termination, will write out a wav file. */
+        /** Create a new sound exporter which streams samples to a wav file. The file is a
+            valid wav file after every write; the destructor writes the remaining samples. */
         SoundExporter(const std::string &filename, int channels);
         ~SoundExporter();
 
-        /** Adds a buffer of samples. */ 
+        /** Adds a buffer of samples. Samples are dropped if the file could not be opened
+            or written to; the error is logged once. */
         void addSamples(SampleType *s, int len);
 
     private:
    
-        /** Writes the data to disk. */
-        void writeWAVData();
+        /** Writes the wav header, with empty RIFF/data sizes. */
+        void writeWAVHeader();
+
+        /** Appends samples to the file and patches the RIFF/data sizes. */
+        void writeWAVData(const std::vector<SampleType> &samples);
+
+        /** Background thread writing the pending samples. */
+        void writerLoop();
 
         /** The file to save our audio to. */
         std::string m_filename;
+        std::ofstream m_stream;
 
         /** Number of channels. */
         int m_channels;
 
-        /** The sound data. */
-        std::vector<SampleType> m_data;
+        /** Samples waiting to be written, and the number already in the file. */
+        std::vector<SampleType> m_pending;
+        size_t m_data_size;
 
-        /** Keep track of how many samples have been written since the last write to disk */
-        size_t m_samples_since_write;
+        /** Writer thread state. */
+        bool m_shutdown;
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::thread m_writer;
 };
 
 } // namespace ale::sound 
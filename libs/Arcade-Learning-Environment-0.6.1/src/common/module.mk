@@ -7,6 +7,7 @@ MODULE_OBJS := \
 	src/common/display_screen.o \
 	src/common/ColourPalette.o \
 	src/common/ScreenExporter.o \
+	src/common/EpisodeFile.o \
 	src/common/Constants.o \
     src/common/Log.o
 
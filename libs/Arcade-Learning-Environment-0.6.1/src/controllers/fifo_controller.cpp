@@ -18,10 +18,25 @@
 
 #include <stdio.h>
 #include <cassert>
+#include <cstring>
 #include "../common/Log.hpp"
 
 #define MAX_RUN_LENGTH (0xFF)
 
+// Binary protocol: frame types
+#define FRAME_OBSERVATION ('O')
+#define FRAME_TERMINATE ('D')
+#define FRAME_ACTIONS ('A')
+#define FRAME_HEADER_SIZE (5)
+// Largest number of action pairs in one action frame
+#define MAX_BATCH_ACTIONS (65536)
+
+// Binary protocol: screen encodings
+#define SCREEN_RAW (0)
+#define SCREEN_DELTA (1)
+// Size of the offset and length preceding each run of changed pixels
+#define DELTA_RUN_HEADER_SIZE (8)
+
 static const char hexval[] = { 
     '0', '1', '2', '3', '4', '5', '6', '7', 
     '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' 
@@ -33,9 +48,44 @@ inline void appendByte(char *buf, uInt8 v) {
     *(buf+1) = hexval[v & 0xF];
 }
 
+/* appends a 32-bit value to the buffer, least significant byte first */
+inline void appendUInt32(std::vector<unsigned char>& buf, uInt32 v) {
+    buf.push_back(v & 0xFF);
+    buf.push_back((v >> 8) & 0xFF);
+    buf.push_back((v >> 16) & 0xFF);
+    buf.push_back((v >> 24) & 0xFF);
+}
+
+/* appends raw bytes to the buffer */
+inline void appendBytes(std::vector<unsigned char>& buf, const unsigned char *data, size_t n) {
+    size_t offset = buf.size();
+    buf.resize(offset + n);
+    memcpy(&buf[offset], data, n);
+}
+
+/* overwrites the 32-bit value at the given offset of the buffer */
+inline void writeUInt32(std::vector<unsigned char>& buf, size_t offset, uInt32 v) {
+    buf[offset] = v & 0xFF;
+    buf[offset + 1] = (v >> 8) & 0xFF;
+    buf[offset + 2] = (v >> 16) & 0xFF;
+    buf[offset + 3] = (v >> 24) & 0xFF;
+}
+
+inline uInt32 readUInt32(const unsigned char *buf) {
+    return (uInt32)buf[0] | ((uInt32)buf[1] << 8) | ((uInt32)buf[2] << 16) |
+      ((uInt32)buf[3] << 24);
+}
+
 FIFOController::FIFOController(OSystem* _osystem, bool named_pipes) :
   ALEController(_osystem),
-  m_named_pipes(named_pipes) {
+  m_named_pipes(named_pipes),
+  m_binary(false),
+  m_delta_screen(false),
+  m_has_previous_screen(false),
+  m_num_actions_applied(0),
+  m_fout(NULL),
+  m_fin(NULL),
+  latest_reward(0) {
   m_max_num_frames = m_osystem->settings().getInt("max_num_frames");
   m_run_length_encoding = m_osystem->settings().getBool("run_length_encoding");
 }
@@ -56,10 +106,22 @@ void FIFOController::run() {
     // Send data over to agent
     sendData();
     // Read agent's response & process it
-    readAction(action_a, action_b);
+    if (m_binary) {
+      readBinaryActions();
+    } else {
+      readAction(action_a, action_b);
+      m_actions.assign(1, std::make_pair(action_a, action_b));
+    }
 
-    // Emulate Atari forward
-    latest_reward = applyActions(action_a, action_b);
+    // Emulate Atari forward; the rewards of batched actions add up, and the batch
+    // stops at the end of an episode
+    latest_reward = 0;
+    m_num_actions_applied = 0;
+    while (m_num_actions_applied < m_actions.size()) {
+      const std::pair<Action, Action>& actions = m_actions[m_num_actions_applied++];
+      latest_reward += applyActions(actions.first, actions.second);
+      if (m_environment.isTerminal()) break;
+    }
 
     // Update display if needed
     display();
@@ -67,7 +129,7 @@ void FIFOController::run() {
 
   // Send a termination signal to the agent, if they're still around
   if (!feof(m_fout))
-    fprintf (m_fout, "DIE\n");
+    sendTermination();
 }
 
 bool FIFOController::isDone() {
@@ -112,6 +174,14 @@ void FIFOController::handshake() {
   // Used to be frame skip; now obsolete
   token = strtok(NULL, ",\n");
   m_send_rl = atoi(token);
+  // Optional: 0 for the text protocol, 1 for the binary protocol, 2 for the
+  // binary protocol with screens sent as changes from the previous one
+  token = strtok(NULL, ",\n");
+  if (token != NULL) {
+    int protocol = atoi(token);
+    m_binary = (protocol == 1 || protocol == 2);
+    m_delta_screen = (protocol == 2);
+  }
 }
 
 void FIFOController::openNamedPipes() {
@@ -130,6 +200,11 @@ void FIFOController::openNamedPipes() {
 }
 
 void FIFOController::sendData() {
+  if (m_binary) {
+    sendBinaryData();
+    return;
+  }
+
   if (m_send_ram) sendRAM();
   if (m_send_screen) sendScreen();
   if (m_send_rl) sendRL();
@@ -250,3 +325,131 @@ void FIFOController::readAction(Action& action_a, Action& action_b) {
   action_b = (Action)atoi(token);
 }
 
+
+void FIFOController::sendTermination() {
+  if (m_binary) {
+    m_frame.clear();
+    writeFrame(FRAME_TERMINATE);
+  } else {
+    fprintf (m_fout, "DIE\n");
+  }
+}
+
+void FIFOController::writeFrame(char type) {
+  unsigned char header[FRAME_HEADER_SIZE];
+  header[0] = type;
+  header[1] = m_frame.size() & 0xFF;
+  header[2] = (m_frame.size() >> 8) & 0xFF;
+  header[3] = (m_frame.size() >> 16) & 0xFF;
+  header[4] = (m_frame.size() >> 24) & 0xFF;
+
+  fwrite(header, 1, sizeof(header), m_fout);
+  if (!m_frame.empty()) {
+    fwrite(&m_frame[0], 1, m_frame.size(), m_fout);
+  }
+  fflush(m_fout);
+}
+
+void FIFOController::sendBinaryData() {
+  // Same content as the text protocol: RAM, screen then RL data
+  m_frame.clear();
+
+  if (m_send_ram) {
+    const ALERAM& ram = m_environment.getRAM();
+    appendBytes(m_frame, ram.array(), ram.size());
+  }
+
+  if (m_send_screen) appendBinaryScreen();
+
+  if (m_send_rl) {
+    m_frame.push_back(m_environment.isTerminal() ? 1 : 0);
+    appendUInt32(m_frame, (uInt32)(int)latest_reward);
+    appendUInt32(m_frame, (uInt32)m_num_actions_applied);
+  }
+
+  writeFrame(FRAME_OBSERVATION);
+}
+
+void FIFOController::appendBinaryScreen() {
+  const ALEScreen& screen = m_environment.getScreen();
+  const pixel_t* pixels = screen.getArray();
+  size_t size = screen.arraySize();
+  size_t start = m_frame.size();
+
+  if (m_delta_screen && m_has_previous_screen) {
+    // Runs of pixels which changed since the previous screen; runs separated
+    // by fewer unchanged pixels than a run header are merged
+    const pixel_t* previous = &m_previous_screen[0];
+
+    m_frame.push_back(SCREEN_DELTA);
+    size_t count_offset = m_frame.size();
+    appendUInt32(m_frame, 0);
+
+    uInt32 num_runs = 0;
+    size_t i = 0;
+    while (i < size) {
+      if (pixels[i] == previous[i]) {
+        i++;
+        continue;
+      }
+
+      size_t run_end = i + 1;
+      for (size_t j = run_end; j < size && j - run_end < DELTA_RUN_HEADER_SIZE; j++) {
+        if (pixels[j] != previous[j]) run_end = j + 1;
+      }
+
+      appendUInt32(m_frame, (uInt32)i);
+      appendUInt32(m_frame, (uInt32)(run_end - i));
+      appendBytes(m_frame, pixels + i, run_end - i);
+      num_runs++;
+      i = run_end;
+
+      // Give up once the changes take more room than the screen itself
+      if (m_frame.size() - start > size + 1) break;
+    }
+
+    if (m_frame.size() - start <= size + 1) {
+      writeUInt32(m_frame, count_offset, num_runs);
+      m_previous_screen.assign(pixels, pixels + size);
+      return;
+    }
+    m_frame.resize(start);
+  }
+
+  m_frame.push_back(SCREEN_RAW);
+  appendBytes(m_frame, pixels, size);
+
+  if (m_delta_screen) {
+    m_previous_screen.assign(pixels, pixels + size);
+    m_has_previous_screen = true;
+  }
+}
+
+bool FIFOController::readBinaryActions() {
+  unsigned char header[FRAME_HEADER_SIZE];
+  m_actions.clear();
+
+  if (fread(header, 1, sizeof(header), m_fin) != sizeof(header)) {
+    // As with the text protocol, the other side has probably hung up
+    m_actions.push_back(std::make_pair(PLAYER_A_NOOP, PLAYER_B_NOOP));
+    return false;
+  }
+
+  uInt32 length = readUInt32(header + 1);
+  if (header[0] != FRAME_ACTIONS || length % 2 != 0 || length > 2 * MAX_BATCH_ACTIONS) {
+    ale::Logger::Error << "Invalid frame received from the agent" << std::endl;
+    exit(1);
+  }
+
+  // Pairs of (player A, player B) actions, applied in order
+  m_frame.resize(length);
+  if (length > 0 && fread(&m_frame[0], 1, length, m_fin) != length) {
+    m_actions.push_back(std::make_pair(PLAYER_A_NOOP, PLAYER_B_NOOP));
+    return false;
+  }
+
+  for (uInt32 i = 0; i < length; i += 2) {
+    m_actions.push_back(std::make_pair((Action)m_frame[i], (Action)m_frame[i + 1]));
+  }
+  return true;
+}
@@ -19,6 +19,15 @@
 
 #include "ale_controller.hpp"
 
+#include <utility>
+#include <vector>
+
+/**
+   Besides the text protocol, the controller speaks a binary protocol when the
+   agent asks for it in the handshake. Every binary message is a frame made of a
+   one byte type, a four byte little-endian payload length and the payload; see
+   the FIFO section of the manual for the frame layouts.
+ */
 class FIFOController : public ALEController {
   public:
     FIFOController(OSystem* osystem, bool named_pipes = false);
@@ -33,6 +42,13 @@ class FIFOController : public ALEController {
     bool isDone();
     void sendData();
     void readAction(Action& action_a, Action& action_b);
+    void sendTermination();
+
+    // Binary protocol
+    void sendBinaryData();
+    void appendBinaryScreen();
+    bool readBinaryActions();
+    void writeFrame(char type);
 
     void sendScreen();
     int stringScreenRLE(const ALEScreen& screen, char * buffer);
@@ -49,6 +65,14 @@ class FIFOController : public ALEController {
     bool m_send_screen; // Agent requested screen data
     bool m_send_ram; // Agent requested RAM data
     bool m_send_rl; // Agent requested RL data
+
+    bool m_binary; // Agent requested the binary protocol
+    bool m_delta_screen; // Send screens as changes from the previous one (binary protocol)
+    bool m_has_previous_screen; // m_previous_screen holds the last screen sent
+    std::vector<pixel_t> m_previous_screen;
+    std::vector<unsigned char> m_frame; // Payload of the frame being built
+    std::vector<std::pair<Action, Action> > m_actions; // Actions of the last message
+    size_t m_num_actions_applied; // Actions of the last message applied before the episode ended
     
     FILE* m_fout; 
     FILE* m_fin; 
@@ -4,6 +4,7 @@ MODULE_OBJS := \
 	src/controllers/ale_controller.o \
 	src/controllers/fifo_controller.o \
 	src/controllers/rlglue_controller.o \
+	src/controllers/shm_controller.o \
 	
 MODULE_DIRS += \
 	src/controllers
@@ -0,0 +1,230 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  shm_controller.cpp
+ *
+ *  The ShmController class implements an Agent/ALE interface via a POSIX
+ *  shared memory segment.
+ **************************************************************************** */
+
+#include "shm_controller.hpp"
+
+#include <cstring>
+#include "../common/Log.hpp"
+
+#if !(defined(WIN32) || defined(__MINGW32__))
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// How long ALE sleeps before checking that the agent is still alive
+#define AGENT_CHECK_INTERVAL_MS (1000)
+
+static_assert(sizeof(ALEShmHeader) == 3 * ALE_SHM_ALIGNMENT,
+              "Each part of ALEShmHeader must fill one block");
+
+ShmController::ShmController(OSystem* _osystem) :
+  ALEController(_osystem),
+  m_fd(-1),
+  m_size(0),
+  m_header(NULL),
+  m_act_seq(0),
+  m_agent_gone(false) {
+  m_name = m_osystem->settings().getString("shm_name");
+  m_num_slots = m_osystem->settings().getInt("shm_slots");
+  m_max_num_frames = m_osystem->settings().getInt("max_num_frames");
+}
+
+ShmController::~ShmController() {
+#if !(defined(WIN32) || defined(__MINGW32__))
+  if (m_header != NULL) munmap(m_header, m_size);
+  if (m_fd >= 0) {
+    close(m_fd);
+    shm_unlink(m_name.c_str());
+  }
+#endif
+}
+
+void ShmController::run() {
+  Action action_a, action_b;
+
+  createSegment();
+
+  // Initial observation
+  publishObservation(0);
+
+  while (!isDone()) {
+    // Wait for the agent's response & process it
+    if (!readAction(action_a, action_b)) break;
+
+    // Emulate Atari forward
+    reward_t reward = applyActions(action_a, action_b);
+
+    // Make the result visible to the agent
+    publishObservation(reward);
+
+    // Update display if needed
+    display();
+  }
+
+  // Tell the agent that we are done, if they're still around
+  if (!m_agent_gone)
+    publishTermination();
+}
+
+bool ShmController::isDone() {
+  // Die once we reach enough samples
+  return ((m_max_num_frames > 0 && m_environment.getFrameNumber() >= m_max_num_frames) ||
+    m_agent_gone);
+}
+
+void ShmController::createSegment() {
+#if defined(WIN32) || defined(__MINGW32__)
+  ale::Logger::Error << "The shared memory controller is not supported on this platform"
+    << std::endl;
+  exit(1);
+#else
+  if (m_num_slots < 1) {
+    ale::Logger::Error << "shm_slots must be at least 1" << std::endl;
+    exit(1);
+  }
+
+  const ALEScreen& screen = m_environment.getScreen();
+  const ALERAM& ram = m_environment.getRAM();
+
+  uint32_t header_size = aleShmAlign(sizeof(ALEShmHeader));
+  uint32_t ram_offset = sizeof(ALEShmSlot);
+  uint32_t screen_offset = aleShmAlign(ram_offset + ram.size());
+  uint32_t slot_size = aleShmAlign(screen_offset + screen.arraySize());
+  m_size = header_size + (size_t)m_num_slots * slot_size;
+
+  // The name may still be taken by an ALE which died without cleaning up; the object is
+  // only replaced once its owner is known to be gone
+  m_fd = shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (m_fd < 0 && errno == EEXIST) {
+    if (!staleSegment()) {
+      ale::Logger::Error << "Shared memory object " << m_name << " is in use by another "
+        "process; choose another shm_name, or remove it if no ALE is using it" << std::endl;
+      exit(1);
+    }
+    shm_unlink(m_name.c_str());
+    m_fd = shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  }
+  if (m_fd < 0) {
+    ale::Logger::Error << "Cannot create shared memory object: " << m_name << std::endl;
+    exit(1);
+  }
+  if (ftruncate(m_fd, m_size) != 0) {
+    ale::Logger::Error << "Cannot resize shared memory object: " << m_name << std::endl;
+    exit(1);
+  }
+
+  void* base = mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+  if (base == MAP_FAILED) {
+    ale::Logger::Error << "Cannot map shared memory object: " << m_name << std::endl;
+    exit(1);
+  }
+  m_header = (ALEShmHeader*)base;
+
+  // The object is zero-filled; the agent waits for the magic number
+  m_header->version = ALE_SHM_VERSION;
+  m_header->header_size = header_size;
+  m_header->num_slots = m_num_slots;
+  m_header->slot_size = slot_size;
+  m_header->ram_offset = ram_offset;
+  m_header->ram_size = ram.size();
+  m_header->screen_offset = screen_offset;
+  m_header->screen_width = screen.width();
+  m_header->screen_height = screen.height();
+  m_header->ale_pid = (uint32_t)getpid();
+  aleShmStore(&m_header->magic, ALE_SHM_MAGIC);
+#endif
+}
+
+bool ShmController::staleSegment() const {
+#if defined(WIN32) || defined(__MINGW32__)
+  return false;
+#else
+  int fd = shm_open(m_name.c_str(), O_RDONLY, 0);
+  if (fd < 0) return errno == ENOENT;
+
+  // Stale only if it is a segment of ours whose ALE process no longer exists
+  bool stale = false;
+  struct stat st;
+  if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(ALEShmHeader)) {
+    void* base = mmap(NULL, sizeof(ALEShmHeader), PROT_READ, MAP_SHARED, fd, 0);
+    if (base != MAP_FAILED) {
+      ALEShmHeader* header = (ALEShmHeader*)base;
+      stale = aleShmLoad(&header->magic) == ALE_SHM_MAGIC &&
+        header->version == ALE_SHM_VERSION && header->ale_pid != 0 &&
+        !aleShmAlive(header->ale_pid);
+      munmap(base, sizeof(ALEShmHeader));
+    }
+  }
+  close(fd);
+  return stale;
+#endif
+}
+
+void ShmController::publishObservation(reward_t reward) {
+  uint32_t seq = m_header->obs_seq + 1;
+  ALEShmSlot* slot = aleShmSlot(m_header, seq);
+  unsigned char* data = (unsigned char*)slot;
+
+  slot->frame_number = m_environment.getFrameNumber();
+  slot->episode_frame_number = m_environment.getEpisodeFrameNumber();
+  slot->reward = (int32_t)reward;
+  slot->terminal = m_environment.isTerminal() ? 1 : 0;
+
+  const ALERAM& ram = m_environment.getRAM();
+  memcpy(data + m_header->ram_offset, ram.array(), ram.size());
+  const ALEScreen& screen = m_environment.getScreen();
+  memcpy(data + m_header->screen_offset, screen.getArray(), screen.arraySize());
+
+  aleShmPublish(&m_header->obs_seq, seq, &m_header->agent_waiting);
+}
+
+void ShmController::publishTermination() {
+  m_header->terminated = 1;
+  aleShmPublish(&m_header->obs_seq, m_header->obs_seq + 1, &m_header->agent_waiting);
+}
+
+bool ShmController::readAction(Action& action_a, Action& action_b) {
+  // Sleep in intervals so that an agent which died does not block us forever
+  while (!aleShmWait(&m_header->act_seq, m_act_seq, &m_header->ale_waiting,
+                     AGENT_CHECK_INTERVAL_MS)) {
+    if (!agentAlive()) {
+      m_agent_gone = true;
+      return false;
+    }
+  }
+
+  m_act_seq = aleShmLoad(&m_header->act_seq);
+  if (m_header->detach) {
+    m_agent_gone = true;
+    return false;
+  }
+
+  action_a = (Action)m_header->action_a;
+  action_b = (Action)m_header->action_b;
+  return true;
+}
+
+bool ShmController::agentAlive() const {
+#if !(defined(WIN32) || defined(__MINGW32__))
+  // Until an agent attaches there is nobody to check on
+  return aleShmAlive(aleShmLoad(&m_header->agent_pid));
+#else
+  return true;
+#endif
+}
@@ -0,0 +1,60 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  shm_controller.hpp
+ *
+ *  The ShmController class implements an Agent/ALE interface via a POSIX
+ *  shared memory segment.
+ **************************************************************************** */
+
+#ifndef __SHM_CONTROLLER_HPP__
+#define __SHM_CONTROLLER_HPP__
+
+#include "ale_controller.hpp"
+#include "shm_transport.hpp"
+
+#include <string>
+
+/**
+   Observations are written to a ring of slots in a shared memory segment,
+   where the agent reads them in place; the agent hands its actions back
+   through the segment header. Each side polls briefly and then sleeps on a
+   futex, so that neither data nor wake-ups go through pipes. The layout of the
+   segment is described in shm_transport.hpp.
+ */
+class ShmController : public ALEController {
+  public:
+    ShmController(OSystem* osystem);
+    virtual ~ShmController();
+
+    virtual void run();
+
+  private:
+    void createSegment();
+    bool staleSegment() const;
+    void publishObservation(reward_t reward);
+    void publishTermination();
+    bool readAction(Action& action_a, Action& action_b);
+    bool agentAlive() const;
+    bool isDone();
+
+  private:
+    std::string m_name; // Name of the shared memory object
+    int m_num_slots; // Number of observation slots in the ring
+    int m_max_num_frames; // Maximum number of total frames before we stop
+
+    int m_fd;
+    size_t m_size; // Size of the mapping
+    ALEShmHeader* m_header; // The mapped segment
+    uint32_t m_act_seq; // Number of actions read from the agent
+    bool m_agent_gone; // The agent detached or died
+};
+
+#endif // __SHM_CONTROLLER_HPP__
@@ -0,0 +1,197 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  shm_transport.hpp
+ *
+ *  Layout of the shared memory segment used by the ShmController, and the
+ *  signalling primitives used by both ALE and the agent. This header only
+ *  depends on system headers, so that agents can include it on their own.
+ **************************************************************************** */
+
+#ifndef __SHM_TRANSPORT_HPP__
+#define __SHM_TRANSPORT_HPP__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+#include <time.h>
+#include <limits.h>
+
+#include <signal.h>
+#include <sys/types.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+#define ALE_SHM_MAGIC (0x4D48534Cu)
+#define ALE_SHM_VERSION (2)
+// Size of the blocks the segment is laid out in, so that the fields written by
+// ALE and those written by the agent never share a cache line
+#define ALE_SHM_ALIGNMENT (64)
+// Number of times a side polls before going to sleep in the kernel
+#define ALE_SHM_SPIN (4000)
+// How often a side which waits checks that the other process is still alive
+#define ALE_SHM_CHECK_INTERVAL_MS (100)
+
+/**
+   The segment starts with this header, followed by num_slots observation
+   slots of slot_size bytes each. Observation n (counting from 1) is written to
+   slot (n - 1) % num_slots and stays valid until observation n + num_slots is
+   published, so agents may read it in place without copying it.
+ */
+struct ALEShmHeader {
+  // Constant once magic is set
+  uint32_t magic;           // ALE_SHM_MAGIC once the segment is initialised
+  uint32_t version;         // ALE_SHM_VERSION
+  uint32_t header_size;     // Offset of the first slot
+  uint32_t num_slots;
+  uint32_t slot_size;       // Distance between two slots
+  uint32_t ram_offset;      // Offset of the RAM within a slot
+  uint32_t ram_size;
+  uint32_t screen_offset;   // Offset of the screen within a slot
+  uint32_t screen_width;
+  uint32_t screen_height;
+  uint32_t ale_pid;         // Lets the agent notice that ALE died
+  uint32_t reserved0[ALE_SHM_ALIGNMENT / 4 - 11];
+
+  // Written by ALE
+  uint32_t obs_seq;         // Number of observations published
+  uint32_t ale_waiting;     // Non-zero while ALE sleeps on act_seq
+  uint32_t terminated;      // Set when ALE stops; obs_seq is bumped with it
+  uint32_t reserved1[ALE_SHM_ALIGNMENT / 4 - 3];
+
+  // Written by the agent
+  uint32_t act_seq;         // Number of actions submitted
+  uint32_t agent_waiting;   // Non-zero while the agent sleeps on obs_seq
+  uint32_t agent_pid;       // Lets ALE notice that the agent died
+  uint32_t action_a;        // Player A action of the latest submission
+  uint32_t action_b;        // Player B action of the latest submission
+  uint32_t detach;          // Set by the agent, with act_seq, to stop ALE
+  uint32_t reserved2[ALE_SHM_ALIGNMENT / 4 - 6];
+};
+
+/**
+   Beginning of each slot; the RAM and the screen (one palette index per
+   pixel, row by row) follow at the offsets given in the header.
+ */
+struct ALEShmSlot {
+  uint32_t frame_number;
+  uint32_t episode_frame_number;
+  int32_t reward;           // Reward of the action which led to this observation
+  uint32_t terminal;        // Non-zero at the end of an episode
+};
+
+inline uint32_t aleShmAlign(uint32_t size) {
+  return (size + ALE_SHM_ALIGNMENT - 1) & ~(uint32_t)(ALE_SHM_ALIGNMENT - 1);
+}
+
+inline ALEShmSlot* aleShmSlot(ALEShmHeader* header, uint32_t seq) {
+  return (ALEShmSlot*)((unsigned char*)header + header->header_size +
+    (size_t)((seq - 1) % header->num_slots) * header->slot_size);
+}
+
+inline uint32_t aleShmLoad(const uint32_t* word) {
+  return __atomic_load_n(word, __ATOMIC_ACQUIRE);
+}
+
+inline void aleShmStore(uint32_t* word, uint32_t value) {
+  __atomic_store_n(word, value, __ATOMIC_RELEASE);
+}
+
+/**
+   Stores value into word and wakes the other side if it sleeps on it. Whatever
+   was written before is visible to the other side once it sees the new value.
+ */
+inline void aleShmPublish(uint32_t* word, uint32_t value, uint32_t* waiting) {
+  __atomic_store_n(word, value, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(waiting, __ATOMIC_SEQ_CST) != 0) {
+#ifdef __linux__
+    syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#endif
+  }
+}
+
+/**
+   Waits until word no longer holds value, polling for a while and then
+   sleeping. Returns false if timeout_ms (when not negative) elapses first.
+ */
+inline bool aleShmWait(uint32_t* word, uint32_t value, uint32_t* waiting, int timeout_ms) {
+  for (int i = 0; i < ALE_SHM_SPIN; i++) {
+    if (aleShmLoad(word) != value) return true;
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#endif
+  }
+
+  // The other side checks 'waiting' after publishing, so either it sees the
+  // flag and wakes us, or we see the new value before sleeping
+  __atomic_store_n(waiting, 1, __ATOMIC_SEQ_CST);
+  bool changed = true;
+#ifndef __linux__
+  long slept_us = 0;
+#endif
+  while (__atomic_load_n(word, __ATOMIC_SEQ_CST) == value) {
+#ifdef __linux__
+    struct timespec timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+    if (syscall(SYS_futex, word, FUTEX_WAIT, value,
+                timeout_ms < 0 ? NULL : &timeout, NULL, 0) != 0 &&
+        errno == ETIMEDOUT) {
+      changed = (aleShmLoad(word) != value);
+      break;
+    }
+#else
+    // No futex: sleep briefly and poll again
+    struct timespec pause_time;
+    pause_time.tv_sec = 0;
+    pause_time.tv_nsec = 50000L;
+    nanosleep(&pause_time, NULL);
+    slept_us += 50;
+    if (timeout_ms >= 0 && slept_us >= timeout_ms * 1000L) {
+      changed = (aleShmLoad(word) != value);
+      break;
+    }
+#endif
+  }
+  __atomic_store_n(waiting, 0, __ATOMIC_SEQ_CST);
+  return changed;
+}
+
+/**
+   Whether the process with the given ID still exists; 0 stands for a process
+   which has not attached yet, and counts as alive.
+ */
+inline bool aleShmAlive(uint32_t pid) {
+  return pid == 0 || kill((pid_t)pid, 0) == 0 || errno != ESRCH;
+}
+
+/**
+   Used by the agent: waits for the observation following number seq. Returns
+   false if ALE dies first or, when timeout_ms is not negative, once timeout_ms
+   elapses; in both cases the agent should give up on the segment.
+ */
+inline bool aleShmWaitObservation(ALEShmHeader* header, uint32_t seq, int timeout_ms) {
+  int waited_ms = 0;
+  for (;;) {
+    int interval = ALE_SHM_CHECK_INTERVAL_MS;
+    if (timeout_ms >= 0 && timeout_ms - waited_ms < interval) interval = timeout_ms - waited_ms;
+    if (aleShmWait(&header->obs_seq, seq, &header->agent_waiting, interval)) return true;
+    waited_ms += interval;
+
+    if (!aleShmAlive(aleShmLoad(&header->ale_pid))) return false;
+    if (timeout_ms >= 0 && waited_ms >= timeout_ms) return false;
+  }
+}
+
+#endif // __SHM_TRANSPORT_HPP__
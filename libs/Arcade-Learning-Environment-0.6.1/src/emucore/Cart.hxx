@@ -23,6 +23,7 @@ class Cartridge;
 class System;
 class Properties;
 class Settings;
+class Random;
 
 #include <fstream>
 #include "m6502/src/bspf/src/bspf.hxx"
@@ -47,10 +48,12 @@ class Cartridge : public Device
       @param size     The size of the ROM image 
       @param props    The properties associated with the game
       @param settings The settings associated with the system
+      @param random   The generator which randomizes the cartridge RAM
       @return   Pointer to the new cartridge object allocated on the heap
     */
     static Cartridge* create(const uInt8* image, uInt32 size, 
-        const Properties& props, const Settings& settings);
+        const Properties& props, const Settings& settings,
+        Random& random);
 
     /**
       Create a new cartridge
@@ -193,8 +196,8 @@ class Cartridge : public Device
     static bool isProbablyFE(const uInt8* image, uInt32 size);
 
   private:
-    // Contains info about this cartridge in string format
-    static std::string myAboutString;
+    // Contains info about the last cartridge created by this thread in string format
+    static thread_local std::string myAboutString;
 
     // Copy constructor isn't supported by cartridges so make it private
     Cartridge(const Cartridge&);
@@ -21,6 +21,7 @@
 #include "System.hxx"
 #include "Serializer.hxx"
 #include "Deserializer.hxx"
+#include "SystemSnapshot.hxx"
 #include "Cart4K.hxx"
 using namespace std;
 
@@ -131,6 +132,20 @@ bool Cartridge4K::load(Deserializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Cartridge4K::save(SystemSnapshot& snapshot) const
+{
+  // There is only one bank, so there is nothing else to save
+  snapshot.bank = 0;
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Cartridge4K::load(const SystemSnapshot&)
+{
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge4K::bank(uInt16 bank)
 {
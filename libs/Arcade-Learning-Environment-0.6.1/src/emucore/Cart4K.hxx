@@ -22,6 +22,7 @@
 class System;
 class Serializer;
 class Deserializer;
+struct SystemSnapshot;
 
 #include "m6502/src/bspf/src/bspf.hxx"
 #include "Cart.hxx"
@@ -85,6 +86,22 @@ class Cartridge4K : public Cartridge
     */
     virtual bool load(Deserializer& in);
 
+    /**
+      Saves the current state of this device into the given snapshot.
+
+      @param snapshot The snapshot to save to.
+      @return The result of the save.  True on success, false on failure.
+    */
+    virtual bool save(SystemSnapshot& snapshot) const;
+
+    /**
+      Loads the current state of this device from the given snapshot.
+
+      @param snapshot The snapshot to load from.
+      @return The result of the load.  True on success, false on failure.
+    */
+    virtual bool load(const SystemSnapshot& snapshot);
+
     /**
       Install pages for the specified bank in the system.
 
@@ -29,7 +29,7 @@
 using namespace std;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeAR::CartridgeAR(const uInt8* image, uInt32 size, bool fastbios)
+CartridgeAR::CartridgeAR(const uInt8* image, uInt32 size, bool fastbios, Random& random)
   : my6502(0)
 {
   uInt32 i;
@@ -40,8 +40,6 @@ CartridgeAR::CartridgeAR(const uInt8* image, uInt32 size, bool fastbios)
   memcpy(myLoadImages, image, size);
 
   // Initialize RAM with random values
-  class Random& random = Random::getInstance();
-
   for(i = 0; i < 6 * 1024; ++i)
   {
     myImage[i] = random.next();
@@ -23,6 +23,7 @@ class M6502High;
 class System;
 class Serializer;
 class Deserializer;
+class Random;
 
 #include "m6502/src/bspf/src/bspf.hxx"
 #include "Cart.hxx"
@@ -48,8 +49,9 @@ class CartridgeAR : public Cartridge
       @param image     Pointer to the ROM image
       @param size      The size of the ROM image
       @param fastbios  Whether or not to quickly execute the BIOS code
+      @param random    The generator which randomizes the cartridge RAM
     */
-    CartridgeAR(const uInt8* image, uInt32 size, bool fastbios);
+    CartridgeAR(const uInt8* image, uInt32 size, bool fastbios, Random& random);
 
     /**
       Destructor
@@ -22,6 +22,7 @@
 class System;
 class Serializer;
 class Deserializer;
+class Random;
 
 #include "m6502/src/bspf/src/bspf.hxx"
 #include "Cart.hxx"
@@ -43,8 +44,9 @@ class CartridgeCV : public Cartridge
       Create a new cartridge using the specified image
 
       @param image Pointer to the ROM image
+      @param random The generator which randomizes the cartridge RAM
     */
-    CartridgeCV(const uInt8* image, uInt32 size);
+    CartridgeCV(const uInt8* image, uInt32 size, Random& random);
 
     /**
       Destructor
@@ -22,6 +22,7 @@
 class System;
 class Serializer;
 class Deserializer;
+class Random;
 
 #include "m6502/src/bspf/src/bspf.hxx"
 #include "Cart.hxx"
@@ -62,8 +63,9 @@ class CartridgeE7 : public Cartridge
       Create a new cartridge using the specified image
 
       @param image Pointer to the ROM image
+      @param random The generator which randomizes the cartridge RAM
     */
-    CartridgeE7(const uInt8* image);
+    CartridgeE7(const uInt8* image, Random& random);
  
     /**
       Destructor
@@ -21,6 +21,7 @@
 #include "System.hxx"
 #include "Serializer.hxx"
 #include "Deserializer.hxx"
+#include "SystemSnapshot.hxx"
 #include "CartF4.hxx"
 using namespace std;
 
@@ -157,6 +158,21 @@ bool CartridgeF4::load(Deserializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeF4::save(SystemSnapshot& snapshot) const
+{
+  snapshot.bank = myCurrentBank;
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeF4::load(const SystemSnapshot& snapshot)
+{
+  // Remember what bank we were in
+  bank(snapshot.bank);
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeF4::bank(uInt16 bank)
 { 
@@ -21,6 +21,7 @@
 #include "System.hxx"
 #include "Serializer.hxx"
 #include "Deserializer.hxx"
+#include "SystemSnapshot.hxx"
 #include "CartF6.hxx"
 using namespace std;
 
@@ -198,6 +199,21 @@ bool CartridgeF6::load(Deserializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeF6::save(SystemSnapshot& snapshot) const
+{
+  snapshot.bank = myCurrentBank;
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeF6::load(const SystemSnapshot& snapshot)
+{
+  // Remember what bank we were in
+  bank(snapshot.bank);
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeF6::bank(uInt16 bank)
 { 
@@ -22,6 +22,7 @@
 class System;
 class Serializer;
 class Deserializer;
+class Random;
 
 #include "m6502/src/bspf/src/bspf.hxx"
 #include "Cart.hxx"
@@ -40,8 +41,9 @@ class CartridgeF6SC : public Cartridge
       Create a new cartridge using the specified image
 
       @param image Pointer to the ROM image
+      @param random The generator which randomizes the cartridge RAM
     */
-    CartridgeF6SC(const uInt8* image);
+    CartridgeF6SC(const uInt8* image, Random& random);
  
     /**
       Destructor
@@ -21,6 +21,7 @@
 #include "System.hxx"
 #include "Serializer.hxx"
 #include "Deserializer.hxx"
+#include "SystemSnapshot.hxx"
 #include "CartF8.hxx"
 using namespace std;
 
@@ -182,6 +183,21 @@ bool CartridgeF8::load(Deserializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeF8::save(SystemSnapshot& snapshot) const
+{
+  snapshot.bank = myCurrentBank;
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeF8::load(const SystemSnapshot& snapshot)
+{
+  // Remember what bank we were in
+  bank(snapshot.bank);
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeF8::bank(uInt16 bank)
 { 
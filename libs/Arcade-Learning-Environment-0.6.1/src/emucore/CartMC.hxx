@@ -22,6 +22,7 @@
 class System;
 class Serializer;
 class Deserializer;
+class Random;
 
 #include "m6502/src/bspf/src/bspf.hxx"
 #include "Cart.hxx"
@@ -147,8 +148,9 @@ class CartridgeMC : public Cartridge
 
       @param image Pointer to the ROM image
       @param size The size of the ROM image
+      @param random The generator which randomizes the cartridge RAM
     */
-    CartridgeMC(const uInt8* image, uInt32 size);
+    CartridgeMC(const uInt8* image, uInt32 size, Random& random);
  
     /**
       Destructor
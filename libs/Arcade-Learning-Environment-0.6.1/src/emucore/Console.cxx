@@ -34,6 +34,7 @@
 #include "Keyboard.hxx"
 #include "M6502Hi.hxx"
 #include "M6502Low.hxx"
+#include "M6502Fast.hxx"
 #include "M6532.hxx"
 #include "MediaSrc.hxx"
 #include "Paddles.hxx"
@@ -155,9 +156,13 @@ Console::Console(OSystem* osystem, Cartridge* cart, const Properties& props)
   myControllers[1]->setSystem(mySystem);
 
   M6502* m6502;
-  if(myOSystem->settings().getString("cpu") == "low") {
+  const string& cpu = myOSystem->settings().getString("cpu");
+  if(cpu == "low") {
     m6502 = new M6502Low(1);
   }
+  else if(cpu == "fast") {
+    m6502 = new M6502Fast(1);
+  }
   else {
     m6502 = new M6502High(1);
   }
@@ -16,54 +16,87 @@
 // $Id: Deserializer.cxx,v 1.12 2007/01/01 18:04:47 stephena Exp $
 //============================================================================
 
+#include <cstring>
 #include "Deserializer.hxx"
-#include <sstream>
 using namespace std;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Deserializer::Deserializer(const string stream_str):
-myStream(stream_str) {
-    
+Deserializer::Deserializer(const string& stream_str)
+  : myData(stream_str.data()),
+    mySize(stream_str.size()),
+    myPos(0)
+{
 }
 
-
-
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Deserializer::Deserializer(const char* data, uInt32 size)
+  : myData(data),
+    mySize(size),
+    myPos(0)
+{
+}
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Deserializer::close(void)
 {
-  myStream.clear();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const char* Deserializer::consume(uInt32 size)
+{
+  if(size > mySize - myPos)
+    throw "Deserializer: end of file";
 
+  const char* src = myData + myPos;
+  myPos += size;
+  return src;
+}
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int Deserializer::getInt(void)
 {
-  if(myStream.eof())
-    throw "Deserializer: end of file";
+  const unsigned char* buf = (const unsigned char*)consume(4);
 
   int val = 0;
-  unsigned char buf[4];
-  myStream.read((char*)buf, 4);
   for(int i = 0; i < 4; ++i)
     val += (int)(buf[i]) << (i<<3);
 
   return val;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 Deserializer::getByte(void)
+{
+  return (uInt8)*consume(1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Deserializer::getBytes(uInt8* values, uInt32 size)
+{
+  if(size > 0)
+    memcpy(values, consume(size), size);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string Deserializer::getString(void)
 {
   int len = getInt();
-  string str;
-  str.resize((string::size_type)len);
-  myStream.read(&str[0], (streamsize)len);
+  if(len < 0)
+    throw "Deserializer: data corruption";
 
-  if(myStream.bad())
-    throw "Deserializer: file read failed";
+  return string(consume((uInt32)len), (string::size_type)len);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Deserializer::checkString(const string& str)
+{
+  int len = getInt();
+  if(len < 0)
+    throw "Deserializer: data corruption";
 
-  return str;
+  const char* src = consume((uInt32)len);
+  return (string::size_type)len == str.size() &&
+         memcmp(src, str.data(), len) == 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -19,7 +19,7 @@
 #ifndef DESERIALIZER_HXX
 #define DESERIALIZER_HXX
 
-#include <sstream>
+#include <string>
 #include "m6502/src/bspf/src/bspf.hxx"
 
 /**
@@ -35,15 +35,21 @@
  
  Revised for ALE on Sep 20, 2009
  The new version uses a stringstream (not a file stream)
- 
- TODO: don't copy the whole streams. 
+
+ Revised again for ALE: the data is read in place from the buffer given
+ at construction, which must outlive the Deserializer.
  */
 class Deserializer {
     public:
         /**
-         Creates a new Deserializer device.
+         Creates a new Deserializer device reading from the given string.
+         */
+        Deserializer(const std::string& stream_str);
+
+        /**
+         Creates a new Deserializer device reading 'size' bytes from 'data'.
          */
-        Deserializer(const std::string stream_str);
+        Deserializer(const char* data, uInt32 size);
         
         void close(void);
 
@@ -53,6 +59,21 @@ class Deserializer {
          @result The int value which has been read from the stream.
          */
         int getInt(void);
+
+        /**
+         Reads a single byte from the current input stream.
+
+         @result The byte which has been read from the stream.
+         */
+        uInt8 getByte(void);
+
+        /**
+         Reads an array of bytes from the current input stream.
+
+         @param values The destination of the bytes
+         @param size   The number of bytes to read
+         */
+        void getBytes(uInt8* values, uInt32 size);
         
         /**
          Reads a string from the current input stream.
@@ -60,6 +81,14 @@ class Deserializer {
          @result The string which has been read from the stream.
          */
         std::string getString(void);
+
+        /**
+         Reads a string from the current input stream and compares it
+         with the given one, without building a copy of it.
+
+         @result True if the string read is equal to 'str'.
+         */
+        bool checkString(const std::string& str);
         
         /**
          Reads a boolean value from the current input stream.
@@ -69,9 +98,16 @@ class Deserializer {
         bool getBool(void);
         
         bool isOpen(void) {return true;}
+
+    private:
+        // Returns a pointer to the next 'size' bytes and moves past them
+        const char* consume(uInt32 size);
+
     private:
-        // The stream to get the deserialized data from.
-        std::stringstream myStream;
+        // The data to get the deserialized values from, and the read position
+        const char* myData;
+        uInt32 mySize;
+        uInt32 myPos;
         
         enum {
             TruePattern  = 0xfab1fab2,
@@ -17,12 +17,14 @@
 //============================================================================
 
 #include <assert.h>
+#include <cstring>
 #include "Console.hxx"
 #include "M6532.hxx"
 #include "Switches.hxx"
 #include "System.hxx"
 #include "Serializer.hxx"
 #include "Deserializer.hxx"
+#include "SystemSnapshot.hxx"
 #include "OSystem.hxx"
 #include <iostream>
 using namespace std;
@@ -330,8 +332,7 @@ bool M6532::save(Serializer& out)
 
     // Output the RAM
     out.putInt(128);
-    for(uInt32 t = 0; t < 128; ++t)
-      out.putInt(myRAM[t]);
+    out.putBytes(myRAM, 128);
 
     out.putInt(myTimer);
     out.putInt(myIntervalShift);
@@ -367,8 +368,9 @@ bool M6532::load(Deserializer& in)
 
     // Input the RAM
     uInt32 limit = (uInt32) in.getInt();
-    for(uInt32 t = 0; t < limit; ++t)
-      myRAM[t] = (uInt8) in.getInt();
+    if(limit > 128)
+      return false;
+    in.getBytes(myRAM, limit);
 
     myTimer = (uInt32) in.getInt();
     myIntervalShift = (uInt32) in.getInt();
@@ -394,6 +396,38 @@ bool M6532::load(Deserializer& in)
 }
 
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6532::save(SystemSnapshot& snapshot) const
+{
+  memcpy(snapshot.riot.ram, myRAM, sizeof(myRAM));
+
+  snapshot.riot.timer = myTimer;
+  snapshot.riot.intervalShift = myIntervalShift;
+  snapshot.riot.cyclesWhenTimerSet = myCyclesWhenTimerSet;
+  snapshot.riot.cyclesWhenInterruptReset = myCyclesWhenInterruptReset;
+  snapshot.riot.timerReadAfterInterrupt = myTimerReadAfterInterrupt;
+  snapshot.riot.DDRA = myDDRA;
+  snapshot.riot.DDRB = myDDRB;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6532::load(const SystemSnapshot& snapshot)
+{
+  memcpy(myRAM, snapshot.riot.ram, sizeof(myRAM));
+
+  myTimer = snapshot.riot.timer;
+  myIntervalShift = snapshot.riot.intervalShift;
+  myCyclesWhenTimerSet = snapshot.riot.cyclesWhenTimerSet;
+  myCyclesWhenInterruptReset = snapshot.riot.cyclesWhenInterruptReset;
+  myTimerReadAfterInterrupt = snapshot.riot.timerReadAfterInterrupt;
+  myDDRA = snapshot.riot.DDRA;
+  myDDRB = snapshot.riot.DDRB;
+
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 M6532::M6532(const M6532& c)
     : myConsole(c.myConsole)
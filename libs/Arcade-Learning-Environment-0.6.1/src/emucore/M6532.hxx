@@ -23,6 +23,7 @@ class Console;
 class System;
 class Serializer;
 class Deserializer;
+struct SystemSnapshot;
 
 #include "m6502/src/bspf/src/bspf.hxx"
 #include "m6502/src/Device.hxx"
@@ -93,6 +94,22 @@ class M6532 : public Device
     */
     virtual bool load(Deserializer& in);
 
+    /**
+      Saves the current state of this device into the given snapshot.
+
+      @param snapshot The snapshot to save to.
+      @return The result of the save.  True on success, false on failure.
+    */
+    virtual bool save(SystemSnapshot& snapshot) const;
+
+    /**
+      Loads the current state of this device from the given snapshot.
+
+      @param snapshot The snapshot to load from.
+      @return The result of the load.  True on success, false on failure.
+    */
+    virtual bool load(const SystemSnapshot& snapshot);
+
    public:
     /**
       Get the byte at the specified address
@@ -109,6 +126,14 @@ class M6532 : public Device
     */
     virtual void poke(uInt16 address, uInt8 value);
 
+    /**
+      Answers the 128 bytes of RAM, for reading them without going
+      through the system's page table.
+
+      @return Pointer to the RAM
+    */
+    const uInt8* ram() const { return myRAM; }
+
   private:
     // Reference to the console
     const Console& myConsole;
@@ -119,6 +119,15 @@ class MediaSource
     */
     virtual void setSound(Sound& sound) = 0;
 
+    /**
+      Enables or disables drawing into the frame buffer. When disabled the
+      media source is still emulated exactly (timing, collisions, sound),
+      but the frames it produces are not drawn.
+
+      @param render Whether the next frames should be drawn
+    */
+    virtual void setRendering(bool render) = 0;
+
   private:
     // Copy constructor isn't supported by this class so make it private
     MediaSource(const MediaSource&);
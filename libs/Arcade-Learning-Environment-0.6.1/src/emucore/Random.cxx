@@ -25,9 +25,6 @@
 #include <random>
 #include <sstream>
 
-// A static Random object for compatibility purposes. Don't use this.
-Random Random::s_random;
-
 // Implementation of Random's random number generator wrapper. 
 class Random::Impl {
   
@@ -109,10 +106,6 @@ double Random::nextDouble()
   return m_pimpl->nextDouble();
 }
 
-Random& Random::getInstance() {
-  return s_random;
-}
-
 bool Random::saveState(Serializer& ser) {
   // The mt19937 object's serialization of choice is into a string. 
   std::ostringstream oss;
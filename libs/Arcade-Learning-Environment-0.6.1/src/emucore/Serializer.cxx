@@ -16,14 +16,16 @@
 // $Id: Serializer.cxx,v 1.11 2007/01/01 18:04:49 stephena Exp $
 //============================================================================
 
+#include <cstring>
 #include "Serializer.hxx"
 using namespace std;
 
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Serializer::Serializer(void) {
-    myStream.clear();
-    
+Serializer::Serializer(uInt32 capacity)
+  : myBuffer(capacity > 0 ? capacity : 1),
+    mySize(0)
+{
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -36,20 +38,43 @@ Serializer::~Serializer(void)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::close(void)
 {
-    myStream.clear();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+char* Serializer::reserve(uInt32 size)
+{
+    if(mySize + size > myBuffer.size())
+    {
+        size_t capacity = myBuffer.size();
+        while(capacity < mySize + size)
+            capacity *= 2;
+        myBuffer.resize(capacity);
+    }
+
+    char* dest = &myBuffer[mySize];
+    mySize += size;
+    return dest;
+}
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putInt(int value)
 {
-    unsigned char buf[4];
+    char* buf = reserve(4);
     for(int i = 0; i < 4; ++i)
         buf[i] = (value >> (i<<3)) & 0xff;
-    
-    myStream.write((char*)buf, 4);
-    if(myStream.bad())
-        throw "Serializer: file write failed";
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::putByte(uInt8 value)
+{
+    *reserve(1) = (char)value;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::putBytes(const uInt8* values, uInt32 size)
+{
+    if(size > 0)
+        memcpy(reserve(size), values, size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -57,10 +82,7 @@ void Serializer::putString(const string& str)
 {
     int len = str.length();
     putInt(len);
-    myStream.write(str.data(), (streamsize)len);
-    
-    if(myStream.bad())
-        throw "Serializer: file write failed";
+    putBytes((const uInt8*)str.data(), len);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -68,4 +90,3 @@ void Serializer::putBool(bool b)
 {
     putInt(b ? TruePattern: FalsePattern);
 }
-
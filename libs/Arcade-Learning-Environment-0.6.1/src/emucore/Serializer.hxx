@@ -19,7 +19,8 @@
 #ifndef SERIALIZER_HXX
 #define SERIALIZER_HXX
 
-#include <sstream>
+#include <string>
+#include <vector>
 #include "m6502/src/bspf/src/bspf.hxx"
 
 /**
@@ -27,15 +28,21 @@
   serialized and sent to an output binary file in a system-
   independent way.
 
-  All bytes and integers are written as int's.  Strings are
-  written as characters prepended by the length of the string.
-  Boolean values are written using a special pattern.
+  Integers are written as 4 little-endian bytes, while bytes and
+  byte arrays are written as is.  Strings are written as characters
+  prepended by the length of the string.  Boolean values are written
+  using a special pattern.
 
   @author  Stephen Anthony
   @version $Id: Serializer.hxx,v 1.12 2007/01/01 18:04:49 stephena Exp $
   
   Revised for ALE on Sep 20, 2009
   The new version uses a stringstream (not a file stream)
+
+  Revised again for ALE: data is written into a growable byte buffer
+  which keeps its memory across reset() calls, so that a Serializer
+  reused for repeated saves stops allocating once the buffer is large
+  enough.
 */
 class Serializer
 {
@@ -43,8 +50,9 @@ class Serializer
     /**
       Creates a new Serializer device.
 
+      @param capacity The number of bytes to preallocate
     */
-    Serializer(void);
+    Serializer(uInt32 capacity = 4096);
 
     /**
       Destructor
@@ -59,6 +67,11 @@ class Serializer
     
     bool isOpen(void) {return true;}
 
+    /**
+      Discards the serialized data, keeping the buffer for reuse.
+    */
+    void reset(void) { mySize = 0; }
+
     /**
       Writes an int value to the current output stream.
 
@@ -66,6 +79,21 @@ class Serializer
     */
     void putInt(int value);
 
+    /**
+      Writes a single byte to the current output stream.
+
+      @param value The byte to write to the output stream.
+    */
+    void putByte(uInt8 value);
+
+    /**
+      Writes an array of bytes to the current output stream.
+
+      @param values The bytes to write to the output stream.
+      @param size   The number of bytes to write
+    */
+    void putBytes(const uInt8* values, uInt32 size);
+
     /**
       Writes a string to the current output stream.
 
@@ -80,14 +108,25 @@ class Serializer
     */
     void putBool(bool b);
 
-    // Accessor for myStream
-    // TODO: don't copy the whole streams. 
+    // Accessors for the serialized data; the pointer is valid until the
+    // next write or reset()
+    const char* data(void) const { return &myBuffer[0]; }
+    uInt32 size(void) const { return mySize; }
+
+    // Returns a copy of the serialized data
     std::string get_str(void) const {
-        return myStream.str();
+        return std::string(data(), mySize);
     }
+
+  private:
+    // Returns a pointer to 'size' writable bytes at the end of the data,
+    // growing the buffer if needed
+    char* reserve(uInt32 size);
+
   private:
-    // The stream to send the serialized data to.
-    std::stringstream myStream;
+    // The buffer holding the serialized data, and how much of it is used
+    std::vector<char> myBuffer;
+    uInt32 mySize;
 
     enum {
       TruePattern  = 0xfab1fab2,
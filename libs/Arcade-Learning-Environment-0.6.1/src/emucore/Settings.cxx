@@ -272,7 +272,7 @@ void Settings::usage() {
        "\n"
        " Main arguments:\n"
        "   -help -- prints out help information\n"
-       "   -game_controller [fifo|fifo_named"
+       "   -game_controller [fifo|fifo_named|shm"
 #ifdef __USE_RLGLUE
        "|rlglue"
 #endif
@@ -280,6 +280,7 @@ void Settings::usage() {
        "      Defines how Stella communicates with the player agent:\n"
        "            - 'fifo':       Control occurs through FIFO pipes\n"
        "            - 'fifo_named': Control occurs through named FIFO pipes\n"
+       "            - 'shm':        Control occurs through POSIX shared memory\n"
 #ifdef __USE_RLGLUE
        "            - 'rlglue':     External control via RL-Glue\n"
 #endif
@@ -301,16 +302,38 @@ void Settings::usage() {
        "     Ends each episode after this number of frames. 0 means never.\n"
        "   -color_averaging [true|false] (default: false)\n"
        "     Phosphor blends screens to reduce flicker\n"
+       "   -render_mode [all|last|never] (default: all)\n"
+       "     Frames drawn by the emulator: every frame, only the frames observed at\n"
+       "     the end of each action (faster with frame_skip > 1), or none (RAM only)\n"
        "   -record_screen_dir [save_directory]\n"
        "     Saves game screen images to save_directory\n"
+       "   -record_episode_file [filename]\n"
+       "     Saves game screens to a single episode file (keyframes and deltas)\n"
+       "   -record_screen_compression n (default: -1)\n"
+       "     zlib level (0-9) of the recorded PNGs; -1 selects zlib's default\n"
        "   -repeat_action_probability (default: 0.25)\n"
        "     Stochasticity in the environment. It is the probability the previous "
                 "action will repeated without executing the new one.\n"
+       "   -reset_cache [true|false] (default: false)\n"
+       "     Remembers the state reached after a reset and restores it on later\n"
+       "     resets, instead of emulating the start of the game again\n"
+       "   -reset_cache_size n (default: 75)\n"
+       "     Number of reset states remembered with reset_cache, the least\n"
+       "     recently used being dropped first; 75 covers every power-on\n"
+       "     state of one game mode and difficulty\n"
+       "   -max_num_noop_starts n (default: 0)\n"
+       "     Starts each episode with a random number of NOOP frames, up to n\n"
        "\n"
        " FIFO Controller arguments:\n"
        "   -run_length_encoding [true|false] (default: true)\n"
        "     Encodes data using run-length encoding\n"
        "\n"
+       " Shared Memory Controller arguments:\n"
+       "   -shm_name [name] (default: /ale_shm)\n"
+       "     Name of the POSIX shared memory object shared with the agent\n"
+       "   -shm_slots n (default: 2)\n"
+       "     Number of observations kept in the shared memory ring\n"
+       "\n"
 #ifdef __USE_RLGLUE
        " RL-Glue Controller arguments:\n"
        "   -send_rgb [true|false] (default: false)\n"
@@ -692,7 +715,7 @@ Settings& Settings::operator = (const Settings&)
 void Settings::setDefaultSettings() {
 
     // Stella settings
-    stringSettings.insert(pair<string, string>("cpu", "low")); // Reduce CPU emulation fidelity for speed
+    stringSettings.insert(pair<string, string>("cpu", "low")); // Reduce CPU emulation fidelity for speed ("fast": same, threaded dispatch and pre-decoded ROM)
 
     // Controller settings
     intSettings.insert(pair<string, int>("max_num_frames", 0));
@@ -701,18 +724,28 @@ void Settings::setDefaultSettings() {
     // FIFO controller settings
     boolSettings.insert(pair<string, bool>("run_length_encoding", true));
 
+    // Shared memory controller settings
+    stringSettings.insert(pair<string, string>("shm_name", "/ale_shm"));
+    intSettings.insert(pair<string, int>("shm_slots", 2));
+
     // Environment customization settings
     boolSettings.insert(pair<string, bool>("restricted_action_set", false));
     intSettings.insert(pair<string, int>("random_seed", 0));
     boolSettings.insert(pair<string, bool>("color_averaging", false));
     boolSettings.insert(pair<string, bool>("send_rgb", false));
     intSettings.insert(pair<string, int>("frame_skip", 1));
+    stringSettings.insert(pair<string, string>("render_mode", "all"));
     floatSettings.insert(pair<string, float>("repeat_action_probability", 0.25));
+    boolSettings.insert(pair<string, bool>("reset_cache", false));
+    intSettings.insert(pair<string, int>("reset_cache_size", 75));
+    intSettings.insert(pair<string, int>("max_num_noop_starts", 0));
     stringSettings.insert(pair<string, string>("rom_file", ""));
 
     // Record settings
     intSettings.insert(pair<string, int>("fragsize", 64)); // fragsize to 64 ensures proper sound sync
     stringSettings.insert(pair<string, string>("record_screen_dir", ""));
+    intSettings.insert(pair<string, int>("record_screen_compression", -1));
+    stringSettings.insert(pair<string, string>("record_episode_file", ""));
     stringSettings.insert(pair<string, string>("record_sound_filename", ""));
 
     // Display Settings
@@ -0,0 +1,106 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll       
+//  SS  SS   tt           ll   ll        
+//  SS     tttttt  eeee   ll   ll   aaaa 
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+//
+// See the file "license" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+//============================================================================
+
+#ifndef SYSTEMSNAPSHOT_HXX
+#define SYSTEMSNAPSHOT_HXX
+
+#include "m6502/src/bspf/src/bspf.hxx"
+
+/**
+  A flat, fixed-size copy of the state saved by System::saveState for
+  consoles whose cartridge holds no state besides its current bank
+  (2K, 4K and the plain F8/F6/F4 bank-switching schemes).  Since it
+  is plain data, a snapshot can be copied around with memcpy and
+  saving or loading one does not allocate.
+
+  The TIA sound registers are not part of the snapshot.
+
+  Revised for ALE
+*/
+struct SystemSnapshot
+{
+  // System
+  uInt32 cycles;
+
+  // 6502 microprocessor
+  struct
+  {
+    uInt8 A, X, Y, SP, IR;
+    uInt16 PC;
+    bool N, V, B, D, I, notZ, C;
+    uInt8 executionStatus;
+
+    // Only used by the high compatibility CPU
+    uInt32 numberOfDistinctAccesses;
+    uInt16 lastAddress;
+  } cpu;
+
+  // 6532 RAM/IO/Timer
+  struct
+  {
+    uInt8 ram[128];
+    uInt32 timer;
+    uInt32 intervalShift;
+    Int32 cyclesWhenTimerSet;
+    Int32 cyclesWhenInterruptReset;
+    bool timerReadAfterInterrupt;
+    uInt8 DDRA, DDRB;
+  } riot;
+
+  // Television Interface Adaptor
+  struct
+  {
+    Int32 clockWhenFrameStarted;
+    Int32 clockStartDisplay;
+    Int32 clockStopDisplay;
+    Int32 clockAtLastUpdate;
+    Int32 clocksToEndOfScanLine;
+    Int32 scanlineCountForLastFrame;
+    Int32 currentScanline;
+    Int32 VSYNCFinishClock;
+
+    uInt8 enabledObjects;
+    uInt8 VSYNC, VBLANK;
+    uInt8 NUSIZ0, NUSIZ1;
+    uInt32 COLUP0, COLUP1, COLUPF, COLUBK;
+    uInt8 CTRLPF;
+    uInt8 playfieldPriorityAndScore;
+    bool REFP0, REFP1;
+    uInt32 PF;
+    uInt8 GRP0, GRP1, DGRP0, DGRP1;
+    bool ENAM0, ENAM1, ENABL, DENABL;
+    Int8 HMP0, HMP1, HMM0, HMM1, HMBL;
+    bool VDELP0, VDELP1, VDELBL;
+    bool RESMP0, RESMP1;
+    uInt16 collision;
+    Int16 POSP0, POSP1, POSM0, POSM1, POSBL;
+    uInt8 currentGRP0, currentGRP1;
+
+    Int32 lastHMOVEClock;
+    bool HMOVEBlankEnabled;
+    bool M0CosmicArkMotionEnabled;
+    uInt32 M0CosmicArkCounter;
+
+    bool dumpEnabled;
+    Int32 dumpDisabledCycle;
+  } tia;
+
+  // Cartridge
+  uInt16 bank;
+};
+
+#endif
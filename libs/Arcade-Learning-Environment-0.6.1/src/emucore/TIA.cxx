@@ -28,6 +28,7 @@
 #include "TIA.hxx"
 #include "Serializer.hxx"
 #include "Deserializer.hxx"
+#include "SystemSnapshot.hxx"
 #include "Settings.hxx"
 #include "Sound.hxx"
 using namespace std;
@@ -95,17 +96,9 @@ TIA::TIA(const Console& console, Settings& settings)
     }
   }
 
-  for(i = 0; i < 640; ++i)
-    ourDisabledMaskTable[i] = 0;
-
-  // Compute all of the mask tables
-  computeBallMaskTable();
-  computeCollisionTable();
-  computeMissleMaskTable();
-  computePlayerMaskTable();
-  computePlayerPositionResetWhenTable();
-  computePlayerReflectTable();
-  computePlayfieldMaskTable();
+  // Compute all of the mask tables; they are shared by every TIA, so this is only
+  // done by the first one, even when several are created at once
+  std::call_once(ourTablesComputed, &TIA::computeTables);
 
   // Init stats counters
   myFrameCounter = 0;
@@ -113,6 +106,7 @@ TIA::TIA(const Console& console, Settings& settings)
   myAUDV0 = myAUDV1 = myAUDF0 = myAUDF1 = myAUDC0 = myAUDC1 = 0;
 
   fastUpdate = settings.getBool("fast_tia_update", false);
+  renderFrames = true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -500,6 +494,145 @@ bool TIA::load(Deserializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIA::save(SystemSnapshot& snapshot) const
+{
+  snapshot.tia.clockWhenFrameStarted = myClockWhenFrameStarted;
+  snapshot.tia.clockStartDisplay = myClockStartDisplay;
+  snapshot.tia.clockStopDisplay = myClockStopDisplay;
+  snapshot.tia.clockAtLastUpdate = myClockAtLastUpdate;
+  snapshot.tia.clocksToEndOfScanLine = myClocksToEndOfScanLine;
+  snapshot.tia.scanlineCountForLastFrame = myScanlineCountForLastFrame;
+  snapshot.tia.currentScanline = myCurrentScanline;
+  snapshot.tia.VSYNCFinishClock = myVSYNCFinishClock;
+
+  snapshot.tia.enabledObjects = myEnabledObjects;
+
+  snapshot.tia.VSYNC = myVSYNC;
+  snapshot.tia.VBLANK = myVBLANK;
+  snapshot.tia.NUSIZ0 = myNUSIZ0;
+  snapshot.tia.NUSIZ1 = myNUSIZ1;
+
+  snapshot.tia.COLUP0 = myCOLUP0;
+  snapshot.tia.COLUP1 = myCOLUP1;
+  snapshot.tia.COLUPF = myCOLUPF;
+  snapshot.tia.COLUBK = myCOLUBK;
+
+  snapshot.tia.CTRLPF = myCTRLPF;
+  snapshot.tia.playfieldPriorityAndScore = myPlayfieldPriorityAndScore;
+  snapshot.tia.REFP0 = myREFP0;
+  snapshot.tia.REFP1 = myREFP1;
+  snapshot.tia.PF = myPF;
+  snapshot.tia.GRP0 = myGRP0;
+  snapshot.tia.GRP1 = myGRP1;
+  snapshot.tia.DGRP0 = myDGRP0;
+  snapshot.tia.DGRP1 = myDGRP1;
+  snapshot.tia.ENAM0 = myENAM0;
+  snapshot.tia.ENAM1 = myENAM1;
+  snapshot.tia.ENABL = myENABL;
+  snapshot.tia.DENABL = myDENABL;
+  snapshot.tia.HMP0 = myHMP0;
+  snapshot.tia.HMP1 = myHMP1;
+  snapshot.tia.HMM0 = myHMM0;
+  snapshot.tia.HMM1 = myHMM1;
+  snapshot.tia.HMBL = myHMBL;
+  snapshot.tia.VDELP0 = myVDELP0;
+  snapshot.tia.VDELP1 = myVDELP1;
+  snapshot.tia.VDELBL = myVDELBL;
+  snapshot.tia.RESMP0 = myRESMP0;
+  snapshot.tia.RESMP1 = myRESMP1;
+  snapshot.tia.collision = myCollision;
+  snapshot.tia.POSP0 = myPOSP0;
+  snapshot.tia.POSP1 = myPOSP1;
+  snapshot.tia.POSM0 = myPOSM0;
+  snapshot.tia.POSM1 = myPOSM1;
+  snapshot.tia.POSBL = myPOSBL;
+
+  snapshot.tia.currentGRP0 = myCurrentGRP0;
+  snapshot.tia.currentGRP1 = myCurrentGRP1;
+
+  snapshot.tia.lastHMOVEClock = myLastHMOVEClock;
+  snapshot.tia.HMOVEBlankEnabled = myHMOVEBlankEnabled;
+  snapshot.tia.M0CosmicArkMotionEnabled = myM0CosmicArkMotionEnabled;
+  snapshot.tia.M0CosmicArkCounter = myM0CosmicArkCounter;
+
+  snapshot.tia.dumpEnabled = myDumpEnabled;
+  snapshot.tia.dumpDisabledCycle = myDumpDisabledCycle;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIA::load(const SystemSnapshot& snapshot)
+{
+  myClockWhenFrameStarted = snapshot.tia.clockWhenFrameStarted;
+  myClockStartDisplay = snapshot.tia.clockStartDisplay;
+  myClockStopDisplay = snapshot.tia.clockStopDisplay;
+  myClockAtLastUpdate = snapshot.tia.clockAtLastUpdate;
+  myClocksToEndOfScanLine = snapshot.tia.clocksToEndOfScanLine;
+  myScanlineCountForLastFrame = snapshot.tia.scanlineCountForLastFrame;
+  myCurrentScanline = snapshot.tia.currentScanline;
+  myVSYNCFinishClock = snapshot.tia.VSYNCFinishClock;
+
+  myEnabledObjects = snapshot.tia.enabledObjects;
+
+  myVSYNC = snapshot.tia.VSYNC;
+  myVBLANK = snapshot.tia.VBLANK;
+  myNUSIZ0 = snapshot.tia.NUSIZ0;
+  myNUSIZ1 = snapshot.tia.NUSIZ1;
+
+  myCOLUP0 = snapshot.tia.COLUP0;
+  myCOLUP1 = snapshot.tia.COLUP1;
+  myCOLUPF = snapshot.tia.COLUPF;
+  myCOLUBK = snapshot.tia.COLUBK;
+
+  myCTRLPF = snapshot.tia.CTRLPF;
+  myPlayfieldPriorityAndScore = snapshot.tia.playfieldPriorityAndScore;
+  myREFP0 = snapshot.tia.REFP0;
+  myREFP1 = snapshot.tia.REFP1;
+  myPF = snapshot.tia.PF;
+  myGRP0 = snapshot.tia.GRP0;
+  myGRP1 = snapshot.tia.GRP1;
+  myDGRP0 = snapshot.tia.DGRP0;
+  myDGRP1 = snapshot.tia.DGRP1;
+  myENAM0 = snapshot.tia.ENAM0;
+  myENAM1 = snapshot.tia.ENAM1;
+  myENABL = snapshot.tia.ENABL;
+  myDENABL = snapshot.tia.DENABL;
+  myHMP0 = snapshot.tia.HMP0;
+  myHMP1 = snapshot.tia.HMP1;
+  myHMM0 = snapshot.tia.HMM0;
+  myHMM1 = snapshot.tia.HMM1;
+  myHMBL = snapshot.tia.HMBL;
+  myVDELP0 = snapshot.tia.VDELP0;
+  myVDELP1 = snapshot.tia.VDELP1;
+  myVDELBL = snapshot.tia.VDELBL;
+  myRESMP0 = snapshot.tia.RESMP0;
+  myRESMP1 = snapshot.tia.RESMP1;
+  myCollision = snapshot.tia.collision;
+  myPOSP0 = snapshot.tia.POSP0;
+  myPOSP1 = snapshot.tia.POSP1;
+  myPOSM0 = snapshot.tia.POSM0;
+  myPOSM1 = snapshot.tia.POSM1;
+  myPOSBL = snapshot.tia.POSBL;
+
+  myCurrentGRP0 = snapshot.tia.currentGRP0;
+  myCurrentGRP1 = snapshot.tia.currentGRP1;
+
+  myLastHMOVEClock = snapshot.tia.lastHMOVEClock;
+  myHMOVEBlankEnabled = snapshot.tia.HMOVEBlankEnabled;
+  myM0CosmicArkMotionEnabled = snapshot.tia.M0CosmicArkMotionEnabled;
+  myM0CosmicArkCounter = snapshot.tia.M0CosmicArkCounter;
+
+  myDumpEnabled = snapshot.tia.dumpEnabled;
+  myDumpDisabledCycle = snapshot.tia.dumpDisabledCycle;
+
+  // Reset TIA bits to be on
+  enableBits(true);
+
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::update()
 {
@@ -721,6 +854,27 @@ void TIA::setSound(Sound& sound)
   mySound = &sound;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::setRendering(bool render)
+{
+  renderFrames = render;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::computeTables()
+{
+  for(uInt32 i = 0; i < 640; ++i)
+    ourDisabledMaskTable[i] = 0;
+
+  computeBallMaskTable();
+  computeCollisionTable();
+  computeMissleMaskTable();
+  computePlayerMaskTable();
+  computePlayerPositionResetWhenTable();
+  computePlayerReflectTable();
+  computePlayfieldMaskTable();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::computeBallMaskTable()
 {
@@ -1859,7 +2013,7 @@ inline void TIA::updateFrame(Int32 clock)
     // Update as much of the scanline as we can
     if(clocksToUpdate != 0)
     {
-      if (fastUpdate)
+      if (fastUpdate || !renderFrames)
         updateFrameScanlineFast(clocksToUpdate, 
           clocksFromStartOfScanLine - HBLANK);
       else
@@ -2909,6 +3063,9 @@ void TIA::poke(uInt16 addr, uInt8 value)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::once_flag TIA::ourTablesComputed;
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 TIA::ourBallMaskTable[4][4][320];
 
@@ -23,6 +23,7 @@ class Console;
 class System;
 class Serializer;
 class Deserializer;
+struct SystemSnapshot;
 class Settings;
 
 #include "m6502/src/bspf/src/bspf.hxx"
@@ -30,6 +31,8 @@ class Settings;
 #include "m6502/src/Device.hxx"
 #include "MediaSrc.hxx"
 
+#include <mutex>
+
 /**
   This class is a device that emulates the Television Interface Adapator 
   found in the Atari 2600 and 7800 consoles.  The Television Interface 
@@ -111,6 +114,22 @@ class TIA : public Device , public MediaSource
     */
     virtual bool load(Deserializer& in);
 
+    /**
+      Saves the current state of this device into the given snapshot.
+
+      @param snapshot The snapshot to save to.
+      @return The result of the save.  True on success, false on failure.
+    */
+    virtual bool save(SystemSnapshot& snapshot) const;
+
+    /**
+      Loads the current state of this device from the given snapshot.
+
+      @param snapshot The snapshot to load from.
+      @return The result of the load.  True on success, false on failure.
+    */
+    virtual bool load(const SystemSnapshot& snapshot);
+
   public:
     /**
       Get the byte at the specified address
@@ -183,6 +202,12 @@ class TIA : public Device , public MediaSource
     */
     void setSound(Sound& sound);
 
+    /**
+      Enables or disables drawing into the frame buffer. Collisions and
+      timing are still computed when drawing is disabled.
+    */
+    void setRendering(bool render);
+
     enum TIABit {
       P0,   // Descriptor for Player 0 Bit
       P1,   // Descriptor for Player 1 Bit
@@ -234,26 +259,29 @@ class TIA : public Device , public MediaSource
 #endif
 
   private:
+    // Compute all of the tables below
+    static void computeTables();
+
     // Compute the ball mask table
-    void computeBallMaskTable();
+    static void computeBallMaskTable();
 
     // Compute the collision decode table
-    void computeCollisionTable();
+    static void computeCollisionTable();
 
     // Compute the missle mask table
-    void computeMissleMaskTable();
+    static void computeMissleMaskTable();
 
     // Compute the player mask table
-    void computePlayerMaskTable();
+    static void computePlayerMaskTable();
 
     // Compute the player position reset when table
-    void computePlayerPositionResetWhenTable();
+    static void computePlayerPositionResetWhenTable();
 
     // Compute the player reflect table
-    void computePlayerReflectTable();
+    static void computePlayerReflectTable();
 
     // Compute playfield mask table
-    void computePlayfieldMaskTable();
+    static void computePlayfieldMaskTable();
 
   private:
     // Update the current frame buffer up to one scanline
@@ -510,6 +538,9 @@ class TIA : public Device , public MediaSource
      bool myFrameGreyed;
 
   private:
+    // Set once the tables below have been computed
+    static std::once_flag ourTablesComputed;
+
     // Ball mask table (entries are true or false)
     static uInt8 ourBallMaskTable[4][4][320];
 
@@ -554,6 +585,7 @@ class TIA : public Device , public MediaSource
   /** ALE-specific */
   private:
     bool fastUpdate;
+    bool renderFrames; // Cleared by setRendering(false)
    
     // Updates the frame's scanline but not the frame buffer 
     void updateFrameScanlineFast(uInt32 clocksToUpdate, uInt32 hpos);
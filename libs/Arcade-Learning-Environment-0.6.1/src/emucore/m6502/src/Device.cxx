@@ -35,3 +35,16 @@ void Device::systemCyclesReset()
   // By default I do nothing when my system resets its cycle counter
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Device::save(SystemSnapshot&) const
+{
+  // By default my state can only be saved through a Serializer
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Device::load(const SystemSnapshot&)
+{
+  return false;
+}
+
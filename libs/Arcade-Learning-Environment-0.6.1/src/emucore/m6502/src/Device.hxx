@@ -22,6 +22,7 @@
 class System;
 class Serializer;
 class Deserializer;
+struct SystemSnapshot;
 
 #include "bspf/src/bspf.hxx"
 
@@ -89,6 +90,24 @@ class Device
     */
     virtual bool load(Deserializer& in) = 0;
 
+    /**
+      Saves the current state of this device into the given snapshot.
+
+      @param snapshot The snapshot to save to.
+      @return True on success, false if this device has state which does
+              not fit in a SystemSnapshot.
+    */
+    virtual bool save(SystemSnapshot& snapshot) const;
+
+    /**
+      Loads the current state of this device from the given snapshot.
+
+      @param snapshot The snapshot to load from.
+      @return True on success, false if this device has state which does
+              not fit in a SystemSnapshot.
+    */
+    virtual bool load(const SystemSnapshot& snapshot);
+
   public:
     /**
       Get the byte at the specified address
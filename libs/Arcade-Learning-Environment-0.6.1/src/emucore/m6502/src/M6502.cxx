@@ -17,6 +17,7 @@
 //============================================================================
 
 #include "M6502.hxx"
+#include "SystemSnapshot.hxx"
 
 #ifdef DEBUGGER_SUPPORT
   #include "Expression.hxx"
@@ -36,16 +37,11 @@ M6502::M6502(uInt32 systemCyclesPerProcessorCycle)
   myWriteTraps  = NULL;
 #endif
 
-  // Compute the BCD lookup table
-  uInt16 t;
-  for(t = 0; t < 256; ++t)
-  {
-    ourBCDTable[0][t] = ((t >> 4) * 10) + (t & 0x0f);
-    ourBCDTable[1][t] = (((t % 100) / 10) << 4) | (t % 10);
-  }
+  // Compute the BCD lookup table, which is shared by every processor
+  std::call_once(ourBCDTableComputed, &M6502::computeBCDTable);
 
   // Compute the System Cycle table
-  for(t = 0; t < 256; ++t)
+  for(uInt16 t = 0; t < 256; ++t)
   {
     myInstructionSystemCycleTable[t] = ourInstructionProcessorCycleTable[t] *
         mySystemCyclesPerProcessorCycle;
@@ -70,6 +66,11 @@ void M6502::install(System& system)
   mySystem = &system;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::pageAccessChanged(uInt16)
+{
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::reset()
 {
@@ -100,6 +101,52 @@ void M6502::nmi()
   myExecutionStatus |= NonmaskableInterruptBit;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6502::save(SystemSnapshot& snapshot) const
+{
+  snapshot.cpu.A = A;
+  snapshot.cpu.X = X;
+  snapshot.cpu.Y = Y;
+  snapshot.cpu.SP = SP;
+  snapshot.cpu.IR = IR;
+  snapshot.cpu.PC = PC;
+
+  snapshot.cpu.N = N;
+  snapshot.cpu.V = V;
+  snapshot.cpu.B = B;
+  snapshot.cpu.D = D;
+  snapshot.cpu.I = I;
+  snapshot.cpu.notZ = notZ;
+  snapshot.cpu.C = C;
+
+  snapshot.cpu.executionStatus = myExecutionStatus;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6502::load(const SystemSnapshot& snapshot)
+{
+  A = snapshot.cpu.A;
+  X = snapshot.cpu.X;
+  Y = snapshot.cpu.Y;
+  SP = snapshot.cpu.SP;
+  IR = snapshot.cpu.IR;
+  PC = snapshot.cpu.PC;
+
+  N = snapshot.cpu.N;
+  V = snapshot.cpu.V;
+  B = snapshot.cpu.B;
+  D = snapshot.cpu.D;
+  I = snapshot.cpu.I;
+  notZ = snapshot.cpu.notZ;
+  C = snapshot.cpu.C;
+
+  myExecutionStatus = snapshot.cpu.executionStatus;
+
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::stop()
 {
@@ -195,9 +242,22 @@ ostream& operator<<(ostream& out, const M6502::AddressingMode& mode)
   return out;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::computeBCDTable()
+{
+  for(uInt16 t = 0; t < 256; ++t)
+  {
+    ourBCDTable[0][t] = ((t >> 4) * 10) + (t & 0x0f);
+    ourBCDTable[1][t] = (((t % 100) / 10) << 4) | (t % 10);
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 M6502::ourBCDTable[2][256];
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::once_flag M6502::ourBCDTableComputed;
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 M6502::AddressingMode M6502::ourAddressingModeTable[256] = {
     Implied,    IndirectX, Invalid,   IndirectX,    // 0x0?
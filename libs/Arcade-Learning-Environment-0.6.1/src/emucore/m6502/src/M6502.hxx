@@ -23,6 +23,7 @@ class D6502;
 class M6502;
 class Serializer;
 class Deserializer;
+struct SystemSnapshot;
 class Debugger;
 class CpuDebug;
 class Expression;
@@ -35,6 +36,8 @@ class PackedBitArray;
 #include "StringList.hxx"
 #endif
 
+#include <mutex>
+
 typedef Common::Array<Expression*> ExpressionList;
 
 /**
@@ -88,6 +91,14 @@ class M6502
     */
     virtual void install(System& system);
 
+    /**
+      Invoked by the system anytime the access methods of a page are
+      changed (for example by bank switching).
+
+      @param page The page whose access methods changed
+    */
+    virtual void pageAccessChanged(uInt16 page);
+
     /**
       Reset the processor to its power-on state.  This method should not 
       be invoked until the entire 6502 system is constructed and installed
@@ -121,6 +132,22 @@ class M6502
     */
     virtual bool load(Deserializer& in) = 0;
 
+    /**
+      Saves the current state of this processor into the given snapshot.
+
+      @param snapshot The snapshot to save to.
+      @return The result of the save.  True on success, false on failure.
+    */
+    virtual bool save(SystemSnapshot& snapshot) const;
+
+    /**
+      Loads the current state of this processor from the given snapshot.
+
+      @param snapshot The snapshot to load from.
+      @return The result of the load.  True on success, false on failure.
+    */
+    virtual bool load(const SystemSnapshot& snapshot);
+
     /**
       Get a null terminated string which is the processor's name (i.e. "M6532")
 
@@ -298,6 +325,12 @@ class M6502
     /// Lookup table used for binary-code-decimal math
     static uInt8 ourBCDTable[2][256];
 
+    /// Set once ourBCDTable has been computed
+    static std::once_flag ourBCDTableComputed;
+
+    /// Computes ourBCDTable
+    static void computeBCDTable();
+
     /**
       Table of instruction processor cycle times.  In some cases additional 
       cycles will be added during the execution of an instruction.
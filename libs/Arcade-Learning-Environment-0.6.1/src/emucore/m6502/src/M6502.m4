@@ -318,7 +318,8 @@ define(M6502_JSR, `{
   poke(0x0100 + SP--, PC >> 8);
   poke(0x0100 + SP--, PC & 0xff);
 
-  PC = low | ((uInt16)peek(PC++) << 8); 
+  uInt16 high = ((uInt16)peek(PC++) << 8);
+  PC = low | high;
 }')
 
 define(M6502_LAS, `{
@@ -0,0 +1,312 @@
+//============================================================================
+//
+// MM     MM  6666  555555  0000   2222
+// MMMM MMMM 66  66 55     00  00 22  22
+// MM MMM MM 66     55     00  00     22
+// MM  M  MM 66666  55555  00  00  22222  --  "A 6502 Microprocessor Emulator"
+// MM     MM 66  66     55 00  00 22
+// MM     MM 66  66 55  55 00  00 22
+// MM     MM  6666   5555   0000  222222
+//
+// Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+//
+// See the file "license" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id: M6502Fast.cxx $
+//============================================================================
+
+#include "M6502Fast.hxx"
+
+using namespace std;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+M6502Fast::M6502Fast(uInt32 systemCyclesPerProcessorCycle)
+    : M6502Low(systemCyclesPerProcessorCycle)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+M6502Fast::~M6502Fast()
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline uInt8 M6502Fast::peek(uInt16 address)
+{
+  uInt8 result = mySystem->peek(address);
+  myLastAccessWasRead = true;
+  return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void M6502Fast::poke(uInt16 address, uInt8 value)
+{
+  mySystem->poke(address, value);
+  myLastAccessWasRead = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Fast::install(System& system)
+{
+  M6502Low::install(system);
+
+  // Nothing has been decoded yet
+  myDecodedCode.assign(system.numberOfPages() << system.pageShift(),
+                       DecodedInstruction());
+  myCodePageState.assign(system.numberOfPages(), CodeUnknown);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Fast::pageAccessChanged(uInt16 page)
+{
+  // A page writing directly into memory may now write into the memory of
+  // pages which have been decoded, so all of them have to be discarded
+  if(mySystem->getPageAccess(page).directPokeBase != 0)
+  {
+    for(uInt16 i = 0; i < mySystem->numberOfPages(); ++i)
+    {
+      discardPage(i);
+    }
+  }
+  else
+  {
+    discardPage(page);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Fast::discardPage(uInt16 page)
+{
+  if(myCodePageState[page] == CodeDecoded)
+  {
+    DecodedInstruction* code = &myDecodedCode[page << mySystem->pageShift()];
+    for(uInt16 offset = 0; offset <= mySystem->pageMask(); ++offset)
+    {
+      code[offset].valid = false;
+    }
+  }
+  myCodePageState[page] = CodeUnknown;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502Fast::decodePage(uInt16 page)
+{
+  myCodePageState[page] = CodeUncached;
+  if(!mySystem->isPageReadOnly(page))
+  {
+    return;
+  }
+
+  const uInt8* memory = mySystem->getPageAccess(page).directPeekBase;
+  DecodedInstruction* code = &myDecodedCode[page << mySystem->pageShift()];
+
+  for(uInt16 offset = 0; offset <= mySystem->pageMask(); ++offset)
+  {
+    uInt8 opcode = memory[offset];
+
+    // Number of bytes of the instruction
+    uInt16 length;
+    switch(addressingMode(opcode))
+    {
+      case Implied:
+        length = 1;
+        break;
+
+      case Immediate: case Relative: case Zero: case ZeroX: case ZeroY:
+      case IndirectX: case IndirectY:
+        length = 2;
+        break;
+
+      case Absolute: case AbsoluteX: case AbsoluteY: case Indirect:
+        length = 3;
+        break;
+
+      default:
+        length = 0;
+        break;
+    }
+
+    // Instructions running into the next page are left to the system
+    DecodedInstruction& instruction = code[offset];
+    instruction.valid = (length != 0) && (offset + length <= mySystem->pageMask() + 1);
+    if(instruction.valid)
+    {
+      instruction.opcode = opcode;
+      instruction.operand = (length > 1 ? memory[offset + 1] : 0) |
+                            (length > 2 ? (uInt16)memory[offset + 2] << 8 : 0);
+      instruction.lastByte = memory[offset + length - 1];
+    }
+  }
+  myCodePageState[page] = CodeDecoded;
+}
+
+#if defined(__GNUC__)
+
+// Fetches the instruction at the program counter and jumps to its code.
+// Decoded instructions go to the second copy of the instruction code,
+// which takes the bytes of the instruction from 'decodedOperand'; the
+// data bus is left as reading those bytes would have left it.
+#define FETCH_INSTRUCTION                                               \
+  {                                                                     \
+    const DecodedInstruction& decoded = myDecodedCode[codeIndex(PC)];   \
+    if(!decoded.valid && myCodePageState[mySystem->pageOf(PC)] == CodeUnknown) \
+      decodePage(mySystem->pageOf(PC));                                   \
+    if(decoded.valid)                                                   \
+    {                                                                   \
+      IR = decoded.opcode;                                              \
+      ++PC;                                                             \
+      decodedOperand = decoded.operand;                                 \
+      mySystem->setDataBusState(decoded.lastByte);                      \
+      myLastAccessWasRead = true;                                       \
+      mySystem->incrementCycles(myInstructionSystemCycleTable[IR]);     \
+      goto *ourDecodedDispatchTable[IR];                                \
+    }                                                                   \
+    IR = peek(PC++);                                                    \
+    mySystem->incrementCycles(myInstructionSystemCycleTable[IR]);       \
+    goto *ourDispatchTable[IR];                                         \
+  }
+
+// Ends the current instruction: stops when the requested number of
+// instructions is done or the execution status asks for attention,
+// otherwise goes on with the next instruction
+#define NEXT_INSTRUCTION                                        \
+  if((--number == 0) || myExecutionStatus)                      \
+    goto finished;                                              \
+  FETCH_INSTRUCTION
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6502Fast::execute(uInt32 number)
+{
+  // Address of the code of each instruction, indexed by opcode
+  static void* const ourDispatchTable[256] = {
+    &&op_00, &&op_01, &&illegal, &&op_03, &&op_04, &&op_05, &&op_06, &&op_07, &&op_08, &&op_09, &&op_0a, &&op_0b, &&op_0c, &&op_0d, &&op_0e, &&op_0f,
+    &&op_10, &&op_11, &&illegal, &&op_13, &&op_14, &&op_15, &&op_16, &&op_17, &&op_18, &&op_19, &&op_1a, &&op_1b, &&op_1c, &&op_1d, &&op_1e, &&op_1f,
+    &&op_20, &&op_21, &&illegal, &&op_23, &&op_24, &&op_25, &&op_26, &&op_27, &&op_28, &&op_29, &&op_2a, &&op_2b, &&op_2c, &&op_2d, &&op_2e, &&op_2f,
+    &&op_30, &&op_31, &&illegal, &&op_33, &&op_34, &&op_35, &&op_36, &&op_37, &&op_38, &&op_39, &&op_3a, &&op_3b, &&op_3c, &&op_3d, &&op_3e, &&op_3f,
+    &&op_40, &&op_41, &&illegal, &&op_43, &&op_44, &&op_45, &&op_46, &&op_47, &&op_48, &&op_49, &&op_4a, &&op_4b, &&op_4c, &&op_4d, &&op_4e, &&op_4f,
+    &&op_50, &&op_51, &&illegal, &&op_53, &&op_54, &&op_55, &&op_56, &&op_57, &&op_58, &&op_59, &&op_5a, &&op_5b, &&op_5c, &&op_5d, &&op_5e, &&op_5f,
+    &&op_60, &&op_61, &&illegal, &&op_63, &&op_64, &&op_65, &&op_66, &&op_67, &&op_68, &&op_69, &&op_6a, &&op_6b, &&op_6c, &&op_6d, &&op_6e, &&op_6f,
+    &&op_70, &&op_71, &&illegal, &&op_73, &&op_74, &&op_75, &&op_76, &&op_77, &&op_78, &&op_79, &&op_7a, &&op_7b, &&op_7c, &&op_7d, &&op_7e, &&op_7f,
+    &&op_80, &&op_81, &&op_82, &&op_83, &&op_84, &&op_85, &&op_86, &&op_87, &&op_88, &&op_89, &&op_8a, &&op_8b, &&op_8c, &&op_8d, &&op_8e, &&op_8f,
+    &&op_90, &&op_91, &&illegal, &&op_93, &&op_94, &&op_95, &&op_96, &&op_97, &&op_98, &&op_99, &&op_9a, &&op_9b, &&op_9c, &&op_9d, &&op_9e, &&op_9f,
+    &&op_a0, &&op_a1, &&op_a2, &&op_a3, &&op_a4, &&op_a5, &&op_a6, &&op_a7, &&op_a8, &&op_a9, &&op_aa, &&op_ab, &&op_ac, &&op_ad, &&op_ae, &&op_af,
+    &&op_b0, &&op_b1, &&illegal, &&op_b3, &&op_b4, &&op_b5, &&op_b6, &&op_b7, &&op_b8, &&op_b9, &&op_ba, &&op_bb, &&op_bc, &&op_bd, &&op_be, &&op_bf,
+    &&op_c0, &&op_c1, &&op_c2, &&op_c3, &&op_c4, &&op_c5, &&op_c6, &&op_c7, &&op_c8, &&op_c9, &&op_ca, &&op_cb, &&op_cc, &&op_cd, &&op_ce, &&op_cf,
+    &&op_d0, &&op_d1, &&illegal, &&op_d3, &&op_d4, &&op_d5, &&op_d6, &&op_d7, &&op_d8, &&op_d9, &&op_da, &&op_db, &&op_dc, &&op_dd, &&op_de, &&op_df,
+    &&op_e0, &&op_e1, &&op_e2, &&op_e3, &&op_e4, &&op_e5, &&op_e6, &&op_e7, &&op_e8, &&op_e9, &&op_ea, &&op_eb, &&op_ec, &&op_ed, &&op_ee, &&op_ef,
+    &&op_f0, &&op_f1, &&illegal, &&op_f3, &&op_f4, &&op_f5, &&op_f6, &&op_f7, &&op_f8, &&op_f9, &&op_fa, &&op_fb, &&op_fc, &&op_fd, &&op_fe, &&op_ff
+  };
+
+  // Same for the copy of the code taking the bytes of the instruction from
+  // the decoded code
+  static void* const ourDecodedDispatchTable[256] = {
+    &&dop_00, &&dop_01, &&illegal, &&dop_03, &&dop_04, &&dop_05, &&dop_06, &&dop_07, &&dop_08, &&dop_09, &&dop_0a, &&dop_0b, &&dop_0c, &&dop_0d, &&dop_0e, &&dop_0f,
+    &&dop_10, &&dop_11, &&illegal, &&dop_13, &&dop_14, &&dop_15, &&dop_16, &&dop_17, &&dop_18, &&dop_19, &&dop_1a, &&dop_1b, &&dop_1c, &&dop_1d, &&dop_1e, &&dop_1f,
+    &&dop_20, &&dop_21, &&illegal, &&dop_23, &&dop_24, &&dop_25, &&dop_26, &&dop_27, &&dop_28, &&dop_29, &&dop_2a, &&dop_2b, &&dop_2c, &&dop_2d, &&dop_2e, &&dop_2f,
+    &&dop_30, &&dop_31, &&illegal, &&dop_33, &&dop_34, &&dop_35, &&dop_36, &&dop_37, &&dop_38, &&dop_39, &&dop_3a, &&dop_3b, &&dop_3c, &&dop_3d, &&dop_3e, &&dop_3f,
+    &&dop_40, &&dop_41, &&illegal, &&dop_43, &&dop_44, &&dop_45, &&dop_46, &&dop_47, &&dop_48, &&dop_49, &&dop_4a, &&dop_4b, &&dop_4c, &&dop_4d, &&dop_4e, &&dop_4f,
+    &&dop_50, &&dop_51, &&illegal, &&dop_53, &&dop_54, &&dop_55, &&dop_56, &&dop_57, &&dop_58, &&dop_59, &&dop_5a, &&dop_5b, &&dop_5c, &&dop_5d, &&dop_5e, &&dop_5f,
+    &&dop_60, &&dop_61, &&illegal, &&dop_63, &&dop_64, &&dop_65, &&dop_66, &&dop_67, &&dop_68, &&dop_69, &&dop_6a, &&dop_6b, &&dop_6c, &&dop_6d, &&dop_6e, &&dop_6f,
+    &&dop_70, &&dop_71, &&illegal, &&dop_73, &&dop_74, &&dop_75, &&dop_76, &&dop_77, &&dop_78, &&dop_79, &&dop_7a, &&dop_7b, &&dop_7c, &&dop_7d, &&dop_7e, &&dop_7f,
+    &&dop_80, &&dop_81, &&dop_82, &&dop_83, &&dop_84, &&dop_85, &&dop_86, &&dop_87, &&dop_88, &&dop_89, &&dop_8a, &&dop_8b, &&dop_8c, &&dop_8d, &&dop_8e, &&dop_8f,
+    &&dop_90, &&dop_91, &&illegal, &&dop_93, &&dop_94, &&dop_95, &&dop_96, &&dop_97, &&dop_98, &&dop_99, &&dop_9a, &&dop_9b, &&dop_9c, &&dop_9d, &&dop_9e, &&dop_9f,
+    &&dop_a0, &&dop_a1, &&dop_a2, &&dop_a3, &&dop_a4, &&dop_a5, &&dop_a6, &&dop_a7, &&dop_a8, &&dop_a9, &&dop_aa, &&dop_ab, &&dop_ac, &&dop_ad, &&dop_ae, &&dop_af,
+    &&dop_b0, &&dop_b1, &&illegal, &&dop_b3, &&dop_b4, &&dop_b5, &&dop_b6, &&dop_b7, &&dop_b8, &&dop_b9, &&dop_ba, &&dop_bb, &&dop_bc, &&dop_bd, &&dop_be, &&dop_bf,
+    &&dop_c0, &&dop_c1, &&dop_c2, &&dop_c3, &&dop_c4, &&dop_c5, &&dop_c6, &&dop_c7, &&dop_c8, &&dop_c9, &&dop_ca, &&dop_cb, &&dop_cc, &&dop_cd, &&dop_ce, &&dop_cf,
+    &&dop_d0, &&dop_d1, &&illegal, &&dop_d3, &&dop_d4, &&dop_d5, &&dop_d6, &&dop_d7, &&dop_d8, &&dop_d9, &&dop_da, &&dop_db, &&dop_dc, &&dop_dd, &&dop_de, &&dop_df,
+    &&dop_e0, &&dop_e1, &&dop_e2, &&dop_e3, &&dop_e4, &&dop_e5, &&dop_e6, &&dop_e7, &&dop_e8, &&dop_e9, &&dop_ea, &&dop_eb, &&dop_ec, &&dop_ed, &&dop_ee, &&dop_ef,
+    &&dop_f0, &&dop_f1, &&illegal, &&dop_f3, &&dop_f4, &&dop_f5, &&dop_f6, &&dop_f7, &&dop_f8, &&dop_f9, &&dop_fa, &&dop_fb, &&dop_fc, &&dop_fd, &&dop_fe, &&dop_ff
+  };
+
+  // Clear all of the execution status bits except for the fatal error bit
+  myExecutionStatus &= FatalErrorBit;
+
+  // Loop until execution is stopped or a fatal error occurs
+  for(;;)
+  {
+    if(!myExecutionStatus && (number != 0))
+    {
+      uInt16 operandAddress = 0;
+      uInt8 operand = 0;
+      uInt16 decodedOperand = 0;
+
+      // Fetch the first instruction; each instruction then fetches the
+      // one following it
+      FETCH_INSTRUCTION
+
+      // 6502 instruction emulation is generated by an M4 macro file.  It
+      // is included twice: the first copy reads the bytes of the
+      // instruction from the system, the second one from the decoded code
+      #define OPCODE(_code) op_##_code
+      #define FETCH_BYTE() peek(PC++)
+      #define FETCH_WORD() ((uInt16)peek(PC) | ((uInt16)peek(PC + 1) << 8))
+      #include "M6502Fast.ins"
+      #undef OPCODE
+      #undef FETCH_BYTE
+      #undef FETCH_WORD
+
+      #define OPCODE(_code) dop_##_code
+      #define FETCH_BYTE() (++PC, (uInt8)decodedOperand)
+      #define FETCH_WORD() (decodedOperand)
+      #include "M6502Fast.ins"
+      #undef OPCODE
+      #undef FETCH_BYTE
+      #undef FETCH_WORD
+
+    illegal:
+      // Oops, illegal instruction executed so set fatal error flag
+      myExecutionStatus |= FatalErrorBit;
+      cerr << "Illegal Instruction! " << hex << (int) IR << endl;
+      NEXT_INSTRUCTION;
+
+    finished:
+      // Silence 'set but not used' warnings for the last instruction
+      (void)operandAddress;
+      (void)operand;
+      (void)decodedOperand;
+    }
+
+    // See if we need to handle an interrupt
+    if((myExecutionStatus & MaskableInterruptBit) ||
+        (myExecutionStatus & NonmaskableInterruptBit))
+    {
+      // Yes, so handle the interrupt
+      interruptHandler();
+    }
+
+    // See if execution has been stopped
+    if(myExecutionStatus & StopExecutionBit)
+    {
+      // Yes, so answer that everything finished fine
+      return true;
+    }
+
+    // See if a fatal error has occured
+    if(myExecutionStatus & FatalErrorBit)
+    {
+      // Yes, so answer that something when wrong
+      return false;
+    }
+
+    // See if we've executed the specified number of instructions
+    if(number == 0)
+    {
+      // Yes, so answer that everything finished fine
+      return true;
+    }
+  }
+}
+
+#undef NEXT_INSTRUCTION
+#undef FETCH_INSTRUCTION
+
+#else
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6502Fast::execute(uInt32 number)
+{
+  return M6502Low::execute(number);
+}
+
+#endif
@@ -0,0 +1,167 @@
+//============================================================================
+//
+// MM     MM  6666  555555  0000   2222
+// MMMM MMMM 66  66 55     00  00 22  22
+// MM MMM MM 66     55     00  00     22
+// MM  M  MM 66666  55555  00  00  22222  --  "A 6502 Microprocessor Emulator"
+// MM     MM 66  66     55 00  00 22
+// MM     MM 66  66 55  55 00  00 22
+// MM     MM  6666   5555   0000  222222
+//
+// Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+//
+// See the file "license" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id: M6502Fast.hxx $
+//============================================================================
+
+#ifndef M6502FAST_HXX
+#define M6502FAST_HXX
+
+class M6502Fast;
+
+#include "bspf/src/bspf.hxx"
+#include "M6502Low.hxx"
+
+#include <vector>
+
+/**
+  This class provides the same low compatibility 6502 emulation as
+  M6502Low, with a faster instruction dispatch: every opcode has a
+  label (see M6502Fast.ins) and each instruction jumps straight to
+  the next one through a table of label addresses, instead of going
+  back through the loop and the switch statement.
+
+  Instructions in read only memory (see System::isPageReadOnly()) are
+  also decoded ahead of time, one page at a time: the opcode and
+  operand of each instruction are read once, and later executions of
+  the instruction take them from the decoded code instead of reading
+  them from the system again.  The decoded code of a page is
+  discarded when its access methods change, as in bank switching.
+
+  The state of the processor and its observable behaviour, including
+  the saved state and the data bus, are the same as those of M6502Low.
+  Debugger traps and breakpoints are not supported; with compilers
+  lacking the "labels as values" extension the switch of M6502Low is
+  used.
+
+  @author  Bradford W. Mott
+  @version $Id: M6502Fast.hxx $
+*/
+class M6502Fast : public M6502Low
+{
+  public:
+    /**
+      Create a new low compatibility 6502 microprocessor with the specified
+      cycle multiplier.
+
+      @param systemCyclesPerProcessorCycle The cycle multiplier
+    */
+    M6502Fast(uInt32 systemCyclesPerProcessorCycle);
+
+    /**
+      Destructor
+    */
+    virtual ~M6502Fast();
+
+  public:
+    /**
+      Execute instructions until the specified number of instructions
+      is executed, someone stops execution, or an error occurs.  Answers
+      true iff execution stops normally.
+
+      @param number Indicates the number of instructions to execute
+      @return true iff execution stops normally
+    */
+    virtual bool execute(uInt32 number);
+
+    /**
+      Install the processor in the specified system.  Invoked by the
+      system when the processor is attached to it.
+
+      @param system The system the processor should install itself in
+    */
+    virtual void install(System& system);
+
+    /**
+      Invoked by the system anytime the access methods of a page are
+      changed; discards the decoded code of the page.
+
+      @param page The page whose access methods changed
+    */
+    virtual void pageAccessChanged(uInt16 page);
+
+  protected:
+    /*
+      Get the byte at the specified address
+
+      @return The byte at the specified address
+    */
+    inline uInt8 peek(uInt16 address);
+
+    /**
+      Change the byte at the specified address to the given value
+
+      @param address The address where the value should be stored
+      @param value The value to be stored at the address
+    */
+    inline void poke(uInt16 address, uInt8 value);
+
+  private:
+    /**
+      Decodes the instructions of the specified page, if it is read only
+      memory
+
+      @param page The page to decode
+    */
+    void decodePage(uInt16 page);
+
+    /**
+      Discards the decoded code of the specified page
+
+      @param page The page to discard
+    */
+    void discardPage(uInt16 page);
+
+    /**
+      Get the index of the decoded instruction at the specified address
+
+      @param address The address of the instruction
+      @return The index of the instruction in myDecodedCode
+    */
+    uInt32 codeIndex(uInt16 address) const
+    {
+      return ((uInt32)mySystem->pageOf(address) << mySystem->pageShift()) |
+             (address & mySystem->pageMask());
+    }
+
+  private:
+    /**
+      An instruction decoded from read only memory
+    */
+    struct DecodedInstruction
+    {
+      uInt16 operand;   // The bytes following the opcode, low byte first
+      uInt8 opcode;     // The opcode of the instruction
+      uInt8 lastByte;   // The last byte of the instruction
+      bool valid;       // False if the instruction has not been decoded
+    };
+
+    /**
+      State of the decoded code of a page
+    */
+    enum CodePageState
+    {
+      CodeUnknown,      // The page hasn't been decoded yet
+      CodeDecoded,      // The instructions of the page have been decoded
+      CodeUncached      // The page is not read only memory
+    };
+
+    // Decoded instruction at each address of the addressing space
+    std::vector<DecodedInstruction> myDecodedCode;
+
+    // State of the decoded code of each page
+    std::vector<uInt8> myCodePageState;
+};
+#endif
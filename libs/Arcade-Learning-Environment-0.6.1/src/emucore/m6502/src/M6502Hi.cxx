@@ -19,6 +19,7 @@
 #include "M6502Hi.hxx"
 #include "Serializer.hxx"
 #include "Deserializer.hxx"
+#include "SystemSnapshot.hxx"
 
 #ifdef DEBUGGER_SUPPORT
   #include "Debugger.hxx"
@@ -326,6 +327,28 @@ bool M6502High::load(Deserializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6502High::save(SystemSnapshot& snapshot) const
+{
+  M6502::save(snapshot);
+
+  snapshot.cpu.numberOfDistinctAccesses = myNumberOfDistinctAccesses;
+  snapshot.cpu.lastAddress = myLastAddress;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6502High::load(const SystemSnapshot& snapshot)
+{
+  M6502::load(snapshot);
+
+  myNumberOfDistinctAccesses = snapshot.cpu.numberOfDistinctAccesses;
+  myLastAddress = snapshot.cpu.lastAddress;
+
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const char* M6502High::name() const
 {
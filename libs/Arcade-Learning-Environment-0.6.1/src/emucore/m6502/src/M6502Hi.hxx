@@ -22,6 +22,7 @@
 class M6502High;
 class Serializer;
 class Deserializer;
+struct SystemSnapshot;
 
 #include "bspf/src/bspf.hxx"
 #include "M6502.hxx"
@@ -80,6 +81,22 @@ class M6502High : public M6502
     */
     virtual bool load(Deserializer& in);
 
+    /**
+      Saves the current state of this processor into the given snapshot.
+
+      @param snapshot The snapshot to save to.
+      @return The result of the save.  True on success, false on failure.
+    */
+    virtual bool save(SystemSnapshot& snapshot) const;
+
+    /**
+      Loads the current state of this processor from the given snapshot.
+
+      @param snapshot The snapshot to load from.
+      @return The result of the load.  True on success, false on failure.
+    */
+    virtual bool load(const SystemSnapshot& snapshot);
+
     /**
       Get a null terminated string which is the processors's name (i.e. "M6532")
 
@@ -25,6 +25,7 @@
 #include "System.hxx"
 #include "Serializer.hxx"
 #include "Deserializer.hxx"
+#include "SystemSnapshot.hxx"
 using namespace std;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -185,6 +186,12 @@ void System::setPageAccess(uInt16 page, const PageAccess& access)
   assert(access.device != 0);
 
   myPageAccessTable[page] = access;
+
+  // Let the processor discard whatever it derived from the old access methods
+  if(myM6502 != 0)
+  {
+    myM6502->pageAccessChanged(page);
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -196,6 +203,30 @@ const System::PageAccess& System::getPageAccess(uInt16 page)
   return myPageAccessTable[page];
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool System::isPageReadOnly(uInt16 page) const
+{
+  const PageAccess& access = myPageAccessTable[page];
+  if(access.directPeekBase == 0 || access.directPokeBase != 0)
+  {
+    return false;
+  }
+
+  // Some cartridges have RAM which is read and written through different
+  // pages, so make sure that no page writes into the memory of this one
+  const uInt8* begin = access.directPeekBase;
+  const uInt8* end = begin + (1 << myPageSize);
+  for(uInt16 i = 0; i < myNumberOfPages; ++i)
+  {
+    const uInt8* poke = myPageAccessTable[i].directPokeBase;
+    if(poke != 0 && poke < end && poke + (1 << myPageSize) > begin)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool System::saveState(const string& md5sum, Serializer& out)
 {
@@ -247,7 +278,7 @@ bool System::loadState(const string& md5sum, Deserializer& in)
   {
     // Look at the beginning of the state file.  It should contain the md5sum
     // of the current cartridge.  If it doesn't, this state file is invalid.
-    if(in.getString() != md5sum)
+    if(!in.checkString(md5sum))
       return false;
 
     // First load state for this system
@@ -277,6 +308,36 @@ bool System::loadState(const string& md5sum, Deserializer& in)
   return true;  // success
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool System::saveState(SystemSnapshot& snapshot)
+{
+  snapshot.cycles = myCycles;
+
+  if(!myM6502->save(snapshot))
+    return false;
+
+  for(uInt32 i = 0; i < myNumberOfDevices; ++i)
+    if(!myDevices[i]->save(snapshot))
+      return false;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool System::loadState(const SystemSnapshot& snapshot)
+{
+  myCycles = snapshot.cycles;
+
+  if(!myM6502->load(snapshot))
+    return false;
+
+  for(uInt32 i = 0; i < myNumberOfDevices; ++i)
+    if(!myDevices[i]->load(snapshot))
+      return false;
+
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 System::System(const System& s) {
   assert(false);
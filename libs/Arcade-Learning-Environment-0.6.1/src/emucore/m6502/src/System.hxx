@@ -25,6 +25,7 @@ class TIA;
 class NullDevice;
 class Serializer;
 class Deserializer;
+struct SystemSnapshot;
 
 #include "bspf/src/bspf.hxx"
 #include "Device.hxx"
@@ -40,11 +41,9 @@ class Deserializer;
   In general the addressing space will be 8192 (2^13) bytes for a 
   6507 based system and 65536 (2^16) bytes for a 6502 based system.
 
-  TODO: To allow for dynamic code generation we probably need to
-        add a tag to each page that indicates if it is read only
-        memory.  We also need to notify the processor anytime a
-        page access method is changed so that it can clear the
-        dynamic code for that page of memory.
+  The processor is notified anytime a page access method is changed,
+  so that it can clear any code it has decoded from that page of
+  memory (see isPageReadOnly()).
 
   @author  Bradford W. Mott
   @version $Id: System.hxx,v 1.16 2007/01/01 18:04:51 stephena Exp $
@@ -133,6 +132,26 @@ class System
     */
     bool loadState(const std::string& md5sum, Deserializer& in);
 
+    /**
+      Saves the current state of Stella into a flat snapshot.  Calls
+      save on every device and CPU attached to this system.
+
+      @param snapshot The snapshot to save to
+
+      @return  False if some device cannot be saved into a snapshot, else true
+    */
+    bool saveState(SystemSnapshot& snapshot);
+
+    /**
+      Loads the current state of Stella from a flat snapshot.  Calls
+      load on every device and CPU attached to this system.
+
+      @param snapshot The snapshot to load from
+
+      @return  False if some device cannot be loaded from a snapshot, else true
+    */
+    bool loadState(const SystemSnapshot& snapshot);
+
   public:
     /**
       Answer the 6502 microprocessor attached to the system.  If a
@@ -351,6 +370,42 @@ class System
       @return The accessing methods used by the page
     */
     const PageAccess& getPageAccess(uInt16 page);
+
+    /**
+      Answers true iff the specified page is read directly from memory
+      which no page writes to directly, such as cartridge ROM.  Such
+      memory only changes along with the page access methods.
+
+      @param page The page to check
+      @return true iff the page is read only memory
+    */
+    bool isPageReadOnly(uInt16 page) const;
+
+    /**
+      Get the page containing the specified address.
+
+      @param addr The address
+      @return The page the address belongs to
+    */
+    uInt16 pageOf(uInt16 addr) const
+    {
+      return (addr & myAddressMask) >> myPageSize;
+    }
+
+    /**
+      Set the state of the data bus, as a read of the given value from
+      memory would.  Used by processors which take bytes already read
+      from read only memory from elsewhere.
+
+      @param value The value last read
+    */
+    inline void setDataBusState(uInt8 value)
+    {
+    #ifdef DEBUGGER_SUPPORT
+      if(!myDataBusLocked)
+    #endif
+        myDataBusState = value;
+    }
  
   private:
     // Log base 2 of the addressing space size.
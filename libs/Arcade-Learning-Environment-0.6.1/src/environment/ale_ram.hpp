@@ -24,55 +24,80 @@ typedef unsigned char byte_t;
 
 #define RAM_SIZE (128)
 
-/** A simple wrapper around the Atari RAM. */ 
+/** A simple wrapper around the Atari RAM. An ALERAM either holds its own copy of
+    the RAM, or is a read-only view over the emulator RAM that always reflects its
+    current contents. Copying an ALERAM (including a view) yields a stable copy. */ 
 class ALERAM { 
   public:
     ALERAM();
+    /** Creates a view over 'ram', which must hold RAM_SIZE bytes and outlive the view. */
+    explicit ALERAM(const byte_t *ram);
     ALERAM(const ALERAM &rhs);
 
     ALERAM& operator=(const ALERAM &rhs);
 
-    /** Byte accessors */ 
+    /** Byte accessors. Writing through byte() turns a view into a copy. */ 
     byte_t get(unsigned int x) const;
     byte_t *byte(unsigned int x);
    
-    /** Returns the whole array (equivalent to byte(0)). */
-    byte_t *array() const { return (byte_t*)(m_ram); }
+    /** Returns the whole array. The const version reads a view in place; the other one
+        is for writing, and is equivalent to byte(0). */
+    const byte_t *array() const { return data(); }
+    byte_t *array() { return byte(0); }
 
     size_t size() const { return sizeof(m_ram); }
     /** Returns whether two copies of the RAM are equal */
     bool equals(const ALERAM &rhs) const;
 
+    /** Returns whether this is a view over the emulator RAM */
+    bool isView() const { return m_view != NULL; }
+    /** Returns a copy of the RAM as it is now */
+    ALERAM snapshot() const { return ALERAM(*this); }
+
   protected:
+    const byte_t *data() const { return m_view != NULL ? m_view : m_ram; }
+
+    const byte_t *m_view; // Emulator RAM, or NULL if m_ram holds the data
     byte_t m_ram[RAM_SIZE];
 };
 
-inline ALERAM::ALERAM() {
+inline ALERAM::ALERAM() :
+  m_view(NULL) {
+}
+
+inline ALERAM::ALERAM(const byte_t *ram) :
+  m_view(ram) {
 }
 
-inline ALERAM::ALERAM(const ALERAM &rhs) {
+inline ALERAM::ALERAM(const ALERAM &rhs) :
+  m_view(NULL) {
   // Copy data over
-  memcpy(m_ram, rhs.m_ram, sizeof(m_ram));
+  memcpy(m_ram, rhs.data(), sizeof(m_ram));
 }
 
 inline ALERAM& ALERAM::operator=(const ALERAM &rhs) {
-  // Copy data over 
-  memcpy(m_ram, rhs.m_ram, sizeof(m_ram));
+  // Copy data over; memmove as rhs may be a view over our own data
+  memmove(m_ram, rhs.data(), sizeof(m_ram));
+  m_view = NULL;
 
   return *this;
 }
 
 inline bool ALERAM::equals(const ALERAM &rhs) const {
-  return (memcmp(m_ram, rhs.m_ram, size()) == 0);
+  return (memcmp(data(), rhs.data(), size()) == 0);
 }
 
 // Byte accessors 
 inline byte_t ALERAM::get(unsigned int x) const {
   // Wrap RAM around the first 128 bytes
-  return m_ram[x & 0x7F]; 
+  return data()[x & 0x7F]; 
 }
 
 inline byte_t* ALERAM::byte(unsigned int x) {
+  if (m_view != NULL) {
+    memcpy(m_ram, m_view, sizeof(m_ram));
+    m_view = NULL;
+  }
   return &m_ram[x & 0x7F]; 
 }
 
@@ -17,6 +17,7 @@
 #include "../common/Constants.h"
 #include "../games/RomSettings.hpp"
 
+#include <cstring>
 #include <sstream>
 #include <stdexcept>
 
@@ -53,11 +54,11 @@ ALEState::ALEState(const std::string &serialized) {
 
 
 /** Restores ALE to the given previously saved state. */ 
-void ALEState::load(OSystem* osystem, RomSettings* settings, std::string md5, const ALEState &rhs,
-    bool load_system) {
+void ALEState::load(OSystem* osystem, RomSettings* settings, const std::string& md5,
+    const ALEState &rhs, bool load_system) {
   assert(rhs.m_serialized_state.length() > 0);
   
-  // Deserialize the stored string into the emulator state
+  // Deserialize the stored string into the emulator state; the string is read in place
   Deserializer deser(rhs.m_serialized_state);
 
   // A primitive check to produce a meaningful error if this state does not contain osystem info. 
@@ -80,10 +81,18 @@ void ALEState::load(OSystem* osystem, RomSettings* settings, std::string md5, co
   m_difficulty = rhs.m_difficulty;
 }
 
-ALEState ALEState::save(OSystem* osystem, RomSettings* settings, std::string md5, 
+ALEState ALEState::save(OSystem* osystem, RomSettings* settings, const std::string& md5,
     bool save_system) {
+  Serializer ser;
+  ALEState state;
+  save(osystem, settings, md5, save_system, ser, state);
+  return state;
+}
+
+void ALEState::save(OSystem* osystem, RomSettings* settings, const std::string& md5,
+    bool save_system, Serializer& ser, ALEState& dst) {
   // Use the emulator's built-in serialization to save the state
-  Serializer ser; 
+  ser.reset();
   
   // We use 'save_system' as a check at load time. 
   ser.putBool(save_system);
@@ -94,7 +103,50 @@ ALEState ALEState::save(OSystem* osystem, RomSettings* settings, std::string md5
   settings->saveState(ser);
 
   // Now make a copy of this state, also storing the emulator serialization
-  return ALEState(*this, ser.get_str());
+  dst.m_left_paddle = m_left_paddle;
+  dst.m_right_paddle = m_right_paddle;
+  dst.m_frame_number = m_frame_number;
+  dst.m_episode_frame_number = m_episode_frame_number;
+  dst.m_mode = m_mode;
+  dst.m_difficulty = m_difficulty;
+  dst.m_serialized_state.assign(ser.data(), ser.size());
+}
+
+bool ALEState::save(OSystem* osystem, RomSettings* settings, Serializer& ser,
+    ALESnapshot& snapshot) {
+  if (!osystem->console().system().saveState(snapshot.system))
+    return false;
+
+  ser.reset();
+  settings->saveState(ser);
+  if (ser.size() > sizeof(snapshot.rom_settings))
+    return false;
+  memcpy(snapshot.rom_settings, ser.data(), ser.size());
+  snapshot.rom_settings_size = ser.size();
+
+  snapshot.left_paddle = m_left_paddle;
+  snapshot.right_paddle = m_right_paddle;
+  snapshot.frame_number = m_frame_number;
+  snapshot.episode_frame_number = m_episode_frame_number;
+  snapshot.mode = m_mode;
+  snapshot.difficulty = m_difficulty;
+
+  return true;
+}
+
+void ALEState::load(OSystem* osystem, RomSettings* settings, const ALESnapshot& snapshot) {
+  if (!osystem->console().system().loadState(snapshot.system))
+    throw std::runtime_error("Attempting to load a snapshot into an incompatible console.");
+
+  Deserializer deser((const char*)snapshot.rom_settings, snapshot.rom_settings_size);
+  settings->loadState(deser);
+
+  m_left_paddle = snapshot.left_paddle;
+  m_right_paddle = snapshot.right_paddle;
+  m_frame_number = snapshot.frame_number;
+  m_episode_frame_number = snapshot.episode_frame_number;
+  m_mode = snapshot.mode;
+  m_difficulty = snapshot.difficulty;
 }
 
 void ALEState::incrementFrame(int steps /* = 1 */) {
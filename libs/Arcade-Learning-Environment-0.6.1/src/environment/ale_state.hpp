@@ -20,10 +20,12 @@
 
 #include "../emucore/OSystem.hxx"
 #include "../emucore/Event.hxx"
+#include "../emucore/SystemSnapshot.hxx"
 #include <string>
 #include "../common/Log.hpp"
 
 class RomSettings;
+class Serializer;
 
 #define PADDLE_DELTA 23000
 // MGB Values taken from Paddles.cxx (Stella 3.3) - 1400000 * [5,235] / 255
@@ -33,6 +35,27 @@ class RomSettings;
 #define PADDLE_MAX 790196 
 #define PADDLE_DEFAULT_VALUE (((PADDLE_MAX - PADDLE_MIN) / 2) + PADDLE_MIN)
 
+// Room for the RomSettings state inside an ALESnapshot
+#define ALE_SNAPSHOT_ROM_SETTINGS_SIZE 128
+
+/** A fixed-size copy of the environment state, for consoles whose state fits in a
+  *  SystemSnapshot. It is plain data, so it can be copied with memcpy, and cloning into an
+  *  existing snapshot does not allocate. Like ALEState, it does not include pseudorandomness. */
+struct ALESnapshot {
+  SystemSnapshot system;
+
+  int left_paddle;
+  int right_paddle;
+  int frame_number;
+  int episode_frame_number;
+  game_mode_t mode;
+  difficulty_t difficulty;
+
+  // The serialized RomSettings state
+  uInt32 rom_settings_size;
+  uInt8 rom_settings[ALE_SNAPSHOT_ROM_SETTINGS_SIZE];
+};
+
 class ALEState {
   public:
     ALEState();
@@ -95,12 +118,26 @@ class ALEState {
     // The two methods below are meant to be used by StellaEnvironment.
     /** Restores the environment to a previously saved state. If load_system == true, we also
         restore system-specific information (such as the RNG state). */ 
-    void load(OSystem* osystem, RomSettings* settings, std::string md5, const ALEState &rhs,
-              bool load_system);
+    void load(OSystem* osystem, RomSettings* settings, const std::string& md5,
+              const ALEState &rhs, bool load_system);
 
     /** Returns a "copy" of the current state, including the information necessary to restore
       *  the emulator. If save_system == true, this includes the RNG state. */
-    ALEState save(OSystem* osystem, RomSettings* settings, std::string md5, bool save_system);
+    ALEState save(OSystem* osystem, RomSettings* settings, const std::string& md5,
+                  bool save_system);
+
+    /** Same as above, but serializes through 'ser' and writes the copy into 'dst'. The memory
+      *  already held by both is reused, so repeated saves do not allocate. */
+    void save(OSystem* osystem, RomSettings* settings, const std::string& md5,
+              bool save_system, Serializer& ser, ALEState& dst);
+
+    /** Copies the current state into a snapshot, using 'ser' for the RomSettings state.
+      *  Returns false if the emulator state does not fit in a snapshot. */
+    bool save(OSystem* osystem, RomSettings* settings, Serializer& ser,
+              ALESnapshot& snapshot);
+
+    /** Restores the environment to the state held by a snapshot. */
+    void load(OSystem* osystem, RomSettings* settings, const ALESnapshot& snapshot);
 
     /** Reset key presses */
     void resetKeys(Event* event_obj);
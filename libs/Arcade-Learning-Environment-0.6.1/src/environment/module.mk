@@ -4,6 +4,8 @@ MODULE_OBJS := \
 	src/environment/ale_state.o \
 	src/environment/stella_environment.o \
 	src/environment/phosphor_blend.o \
+	src/environment/observation_pipeline.o \
+	src/environment/state_tree.o \
 	
 MODULE_DIRS += \
 	src/environment
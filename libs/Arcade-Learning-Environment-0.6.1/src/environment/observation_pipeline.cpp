@@ -0,0 +1,154 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  observation_pipeline.cpp
+ *
+ *  Turns emulator frames into stacked, downsampled grayscale observations.
+ *
+ **************************************************************************** */
+
+#include "observation_pipeline.hpp"
+#include "../emucore/Console.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+ObservationPipeline::ObservationPipeline(OSystem * osystem, int height, int width,
+                                         int stack_size, bool max_pool):
+    m_osystem(osystem),
+    m_height(height),
+    m_width(width),
+    m_stack_size(stack_size),
+    m_max_pool(max_pool),
+    m_newest(0) {
+
+  if (m_height <= 0 || m_width <= 0 || m_stack_size <= 0)
+    throw std::runtime_error("Observation height, width and stack size must be positive");
+
+  MediaSource& media = m_osystem->console().mediaSource();
+  m_screen_height = media.height();
+  m_screen_width = media.width();
+
+  // Same conversion as ColourPalette::applyPaletteGrayscale()
+  ColourPalette &palette = m_osystem->colourPalette();
+  for (int i = 0; i < 256; i++) {
+    m_grayscale[i] = (uInt8)(palette.getRGB(i | 1) & 0xFF);
+  }
+
+  makeWeights(m_screen_height, m_height, m_rows);
+  makeWeights(m_screen_width, m_width, m_cols);
+
+  m_stack.assign(m_stack_size * m_height * m_width, 0);
+  m_line.resize(m_screen_width);
+  m_resized_line.resize(m_width);
+  m_accumulator.resize(m_width);
+}
+
+void ObservationPipeline::makeWeights(int in, int out, AxisWeights& weights) {
+  double scale = (double)in / out;
+
+  weights.first.resize(out);
+  weights.count.resize(out);
+  weights.weights.clear();
+
+  for (int i = 0; i < out; i++) {
+    // Output pixel i covers source pixels [start, end)
+    double start = i * scale;
+    double end = std::min((i + 1) * scale, (double)in);
+
+    int first = (int)floor(start);
+    int count = 0;
+    for (int s = first; s < end; s++) {
+      double overlap = std::min(end, s + 1.0) - std::max(start, (double)s);
+      if (overlap < 1e-6) continue;
+      if (count == 0) first = s;
+      weights.weights.push_back((float)(overlap / scale));
+      count++;
+    }
+    weights.first[i] = first;
+    weights.count[i] = count;
+  }
+}
+
+void ObservationPipeline::process() {
+  MediaSource& media = m_osystem->console().mediaSource();
+  const uInt8 *current = media.currentFrameBuffer();
+  const uInt8 *previous = media.previousFrameBuffer();
+
+  m_newest = (m_newest + 1) % m_stack_size;
+  uInt8 *output = &m_stack[m_newest * m_height * m_width];
+
+  // Source rows at the boundary of two output rows contribute to both; remember the
+  // last one so that it is only converted once
+  int last_row = -1;
+  const float *row_weight = &m_rows.weights[0];
+
+  for (int r = 0; r < m_height; r++) {
+    std::fill(m_accumulator.begin(), m_accumulator.end(), 0.0f);
+
+    for (int k = 0; k < m_rows.count[r]; k++, row_weight++) {
+      int y = m_rows.first[r] + k;
+
+      if (y != last_row) {
+        // Grayscale, and maximum over the last two frames
+        const uInt8 *cur_line = current + y * m_screen_width;
+        if (m_max_pool) {
+          const uInt8 *prev_line = previous + y * m_screen_width;
+          for (int x = 0; x < m_screen_width; x++)
+            m_line[x] = std::max(m_grayscale[cur_line[x]], m_grayscale[prev_line[x]]);
+        }
+        else {
+          for (int x = 0; x < m_screen_width; x++)
+            m_line[x] = m_grayscale[cur_line[x]];
+        }
+
+        // Horizontal resize
+        const float *col_weight = &m_cols.weights[0];
+        for (int c = 0; c < m_width; c++) {
+          const uInt8 *src = &m_line[m_cols.first[c]];
+          float sum = 0.0f;
+          for (int j = 0; j < m_cols.count[c]; j++)
+            sum += *col_weight++ * src[j];
+          m_resized_line[c] = sum;
+        }
+        last_row = y;
+      }
+
+      // Vertical resize
+      float w = *row_weight;
+      for (int c = 0; c < m_width; c++)
+        m_accumulator[c] += w * m_resized_line[c];
+    }
+
+    for (int c = 0; c < m_width; c++)
+      output[r * m_width + c] = (uInt8)std::min(m_accumulator[c] + 0.5f, 255.0f);
+  }
+}
+
+void ObservationPipeline::reset() {
+  process();
+
+  size_t size = m_height * m_width;
+  const uInt8 *newest = &m_stack[m_newest * size];
+  for (int i = 0; i < m_stack_size; i++) {
+    if (i != m_newest)
+      memcpy(&m_stack[i * size], newest, size);
+  }
+}
+
+void ObservationPipeline::getObservation(uInt8 *tensor) const {
+  size_t size = m_height * m_width;
+  for (int i = 0; i < m_stack_size; i++) {
+    int slot = (m_newest + 1 + i) % m_stack_size;
+    memcpy(tensor + i * size, &m_stack[slot * size], size);
+  }
+}
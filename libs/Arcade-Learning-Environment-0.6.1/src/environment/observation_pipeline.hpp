@@ -0,0 +1,87 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  observation_pipeline.hpp
+ *
+ *  Turns emulator frames into stacked, downsampled grayscale observations.
+ *
+ **************************************************************************** */
+
+#ifndef __OBSERVATION_PIPELINE_HPP__
+#define __OBSERVATION_PIPELINE_HPP__
+
+#include "../emucore/OSystem.hxx"
+
+#include <vector>
+
+/**
+   Produces the usual preprocessed observation of deep RL agents in one pass over
+   the emulator frame buffers: grayscale palette lookup, maximum over the current and
+   previous frames (to remove flicker), area downsampling and a stack of the last
+   observations.
+ */
+class ObservationPipeline {
+  public:
+    /** Observations are height x width; the last stack_size of them are kept. With
+        max_pool unset, only the current frame is looked at. Throws std::runtime_error
+        unless all three sizes are positive. */
+    ObservationPipeline(OSystem *, int height = 84, int width = 84, int stack_size = 4,
+                        bool max_pool = true);
+
+    /** Processes the current frame buffers into the newest observation of the stack. */
+    void process();
+
+    /** Processes the current frame buffers and fills the whole stack with the result,
+        as is done at the start of an episode. */
+    void reset();
+
+    /** Copies the stack, oldest observation first, into a stack_size x height x width
+        tensor owned by the caller. */
+    void getObservation(uInt8 *tensor) const;
+
+    int height() const { return m_height; }
+    int width() const { return m_width; }
+    int stackSize() const { return m_stack_size; }
+    /** Number of bytes written by getObservation(). */
+    size_t observationSize() const { return m_stack.size(); }
+    /** Whether process() looks at the previous frame as well as the current one. */
+    bool usesPreviousFrame() const { return m_max_pool; }
+
+  private:
+    /** Source pixels contributing to an output pixel along one axis, with their weights */
+    struct AxisWeights {
+      std::vector<int> first;      // First source index, per output index
+      std::vector<int> count;      // Number of source indices, per output index
+      std::vector<float> weights;  // count[i] weights per output index, consecutively
+    };
+
+    /** Computes area interpolation weights for resizing 'in' pixels into 'out' pixels */
+    static void makeWeights(int in, int out, AxisWeights& weights);
+
+  private:
+    OSystem *m_osystem;
+
+    int m_height, m_width, m_stack_size;
+    bool m_max_pool;
+    int m_screen_height, m_screen_width;
+
+    uInt8 m_grayscale[256]; // Grayscale value of each palette entry
+    AxisWeights m_rows, m_cols;
+
+    std::vector<uInt8> m_stack; // Ring buffer of stack_size observations
+    int m_newest; // Index of the newest observation in m_stack
+
+    // Scratch space, reused by each call to process()
+    std::vector<uInt8> m_line;
+    std::vector<float> m_resized_line;
+    std::vector<float> m_accumulator;
+};
+
+#endif // __OBSERVATION_PIPELINE_HPP__
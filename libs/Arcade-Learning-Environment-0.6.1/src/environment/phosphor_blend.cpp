@@ -17,78 +17,138 @@
 #include "phosphor_blend.hpp"
 #include "../emucore/Console.hxx"
 
+#include <cstdlib>
+#include <map>
+#include <mutex>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ALE_PHOSPHOR_AVX2
+#include <immintrin.h>
+#endif
+
+// Taken from default Stella settings
+static const int PHOSPHOR_BLEND_RATIO = 77;
+
+namespace {
+
+void blendScalar(const uInt8* table, uInt8* dst, const uInt8* current, const uInt8* previous,
+                 size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    dst[i] = table[(current[i] >> 1) * PhosphorBlend::NUM_COLOURS + (previous[i] >> 1)];
+  }
+}
+
+#ifdef ALE_PHOSPHOR_AVX2
+// Blends 8 pixels, returning one result in the low byte of each dword
+__attribute__((target("avx2")))
+inline __m256i blend8(const uInt8* table, const uInt8* current, const uInt8* previous) {
+  __m256i cv = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)current));
+  __m256i pv = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)previous));
+  __m256i index = _mm256_or_si256(_mm256_slli_epi32(_mm256_srli_epi32(cv, 1), 7),
+                                  _mm256_srli_epi32(pv, 1));
+  return _mm256_and_si256(_mm256_i32gather_epi32((const int*)table, index, 1),
+                          _mm256_set1_epi32(0xFF));
+}
+
+__attribute__((target("avx2")))
+void blendAVX2(const uInt8* table, uInt8* dst, const uInt8* current, const uInt8* previous,
+               size_t n) {
+  const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i a = blend8(table, current + i, previous + i);
+    __m256i b = blend8(table, current + i + 8, previous + i + 8);
+    __m256i c = blend8(table, current + i + 16, previous + i + 16);
+    __m256i d = blend8(table, current + i + 24, previous + i + 24);
+    __m256i bytes = _mm256_packus_epi16(_mm256_packus_epi32(a, b), _mm256_packus_epi32(c, d));
+    _mm256_storeu_si256((__m256i*)(dst + i), _mm256_permutevar8x32_epi32(bytes, order));
+  }
+  blendScalar(table, dst + i, current + i, previous + i, n - i);
+}
+#endif // ALE_PHOSPHOR_AVX2
+
+typedef void (*BlendKernel)(const uInt8*, uInt8*, const uInt8*, const uInt8*, size_t);
+
+BlendKernel selectBlendKernel() {
+#ifdef ALE_PHOSPHOR_AVX2
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return blendAVX2;
+#endif
+  return blendScalar;
+}
+
+} // namespace
+
 PhosphorBlend::PhosphorBlend(OSystem * osystem):
     m_osystem(osystem) {
-  
-  // Taken from default Stella settings
-  m_phosphor_blend_ratio = 77;
-
-  makeAveragePalette();
+  m_blend_table = getBlendTable(m_osystem->colourPalette());
 }
 
 void PhosphorBlend::process(ALEScreen& screen) {
+  static const BlendKernel blend = selectBlendKernel();
+
   Console& console = m_osystem->console();
 
   // Fetch current and previous frame buffers from the emulator
   uInt8 * current_buffer  = console.mediaSource().currentFrameBuffer();
   uInt8 * previous_buffer = console.mediaSource().previousFrameBuffer();
 
-  // Process each pixel in turn
-  for (size_t i = 0; i < screen.arraySize(); i++) { 
-    int cv = current_buffer[i];
-    int pv = previous_buffer[i];
-    
-    // Find out the corresponding rgb color 
-    uInt32 rgb = m_avg_palette[cv][pv];
+  // Look up the blended colour of each pixel
+  blend(&(*m_blend_table)[0], screen.getArray(), current_buffer, previous_buffer,
+        screen.arraySize());
+}
+
+std::shared_ptr<const PhosphorBlend::BlendTable>
+PhosphorBlend::getBlendTable(const ColourPalette &palette) {
+  static std::mutex mutex;
+  static std::map<std::vector<uInt32>, std::shared_ptr<const BlendTable> > tables;
 
-    // Set the corresponding pixel in the array
-    screen.getArray()[i] = rgbToNTSC(rgb);
+  // Tables are keyed by the colours of the palette, since different ROMs may use
+  // different palettes
+  std::vector<uInt32> colours(NUM_COLOURS);
+  for (int c = 0; c < NUM_COLOURS; c++) {
+    colours[c] = palette.getRGB(c << 1);
   }
-}
-void PhosphorBlend::makeAveragePalette() {
-  
-  ColourPalette &palette = m_osystem->colourPalette();
-
-  // Precompute the average RGB values for phosphor-averaged colors c1 and c2.
-  for (int c1 = 0; c1 < 256; c1 += 2) {
-    for (int c2 = 0; c2 < 256; c2 += 2) {
-      int r1, g1, b1;
-      int r2, g2, b2;
-      palette.getRGB(c1, r1, g1, b1);
-      palette.getRGB(c2, r2, g2, b2);
-
-      uInt8 r = getPhosphor(r1, r2);
-      uInt8 g = getPhosphor(g1, g2);
-      uInt8 b = getPhosphor(b1, b2);
-      m_avg_palette[c1][c2] = makeRGB(r, g, b);
-    }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  std::shared_ptr<const BlendTable>& table = tables[colours];
+  if (table.get() == NULL) {
+    BlendTable* new_table = new BlendTable();
+    makeBlendTable(colours, *new_table);
+    table.reset(new_table);
   }
-  
-  // Also make a RGB to NTSC color map. We drop the lowest two bits to speed
-  // the initialization a little. TODO(mgbellemare): Find a better solution.
-  for (int r = 0; r < 256; r += 4) {
-    for (int g = 0; g < 256; g += 4) {  
-      for (int b = 0; b < 256; b += 4) {
-        // For each RGB point, we find its closest NTSC match
-        int minDist = 256 * 3 + 1;
-        int minIndex = -1;
-
-        // Look for the closest NTSC value matching (r,g,b). Odd palette
-        // entries correspond to grayscale values and are ignored.
-        for (int c1 = 0; c1 < 256; c1 += 2) {
-          // Get the RGB corresponding to c1
-          int r1, g1, b1;
-          palette.getRGB(c1, r1, g1, b1);
-
-          int dist = abs(r1 - r) + abs(g1 - g) + abs(b1 - b);
-          if (dist < minDist) {
-            minDist = dist;
-            minIndex = c1;
-          }
-        }
+  return table;
+}
 
-        m_rgb_ntsc[r >> 2][g >> 2][b >> 2] = minIndex;
+void PhosphorBlend::makeBlendTable(const std::vector<uInt32> &colours, BlendTable &table) {
+  table.assign(NUM_COLOURS * NUM_COLOURS + 3, 0);
+
+  for (int c1 = 0; c1 < NUM_COLOURS; c1++) {
+    for (int c2 = 0; c2 < NUM_COLOURS; c2++) {
+      // Average the RGB values of the two colours
+      int r = getPhosphor((colours[c1] >> 16) & 0xFF, (colours[c2] >> 16) & 0xFF);
+      int g = getPhosphor((colours[c1] >> 8) & 0xFF, (colours[c2] >> 8) & 0xFF);
+      int b = getPhosphor(colours[c1] & 0xFF, colours[c2] & 0xFF);
+
+      // Find the closest NTSC match of the result. We drop the lowest two bits of the
+      // averaged colour, which was done to speed up the previous RGB to NTSC map and is
+      // kept so that blended screens are unchanged.
+      r &= ~3; g &= ~3; b &= ~3;
+      int minDist = 256 * 3 + 1;
+      int minIndex = -1;
+      for (int c = 0; c < NUM_COLOURS; c++) {
+        int dist = abs((int)((colours[c] >> 16) & 0xFF) - r) +
+                   abs((int)((colours[c] >> 8) & 0xFF) - g) +
+                   abs((int)(colours[c] & 0xFF) - b);
+        if (dist < minDist) {
+          minDist = dist;
+          minIndex = c << 1;
+        }
       }
+
+      table[c1 * NUM_COLOURS + c2] = minIndex;
     }
   }
 }
@@ -100,21 +160,7 @@ uInt8 PhosphorBlend::getPhosphor(uInt8 v1, uInt8 v2) {
     v2 = tmp;
   }
 
-  uInt32 blendedValue = ((v1 - v2) * m_phosphor_blend_ratio) / 100 + v2;
+  uInt32 blendedValue = ((v1 - v2) * PHOSPHOR_BLEND_RATIO) / 100 + v2;
   if (blendedValue > 255) return 255;
   else return (uInt8) blendedValue;
 }
-
-uInt32 PhosphorBlend::makeRGB(uInt8 r, uInt8 g, uInt8 b) {
-  return (r << 16) | (g << 8) | b;
-}
-
-/** Converts a RGB value to an 8-bit format */
-uInt8 PhosphorBlend::rgbToNTSC(uInt32 rgb) {
-  int r = (rgb >> 16) & 0xFF;
-  int g = (rgb >> 8) & 0xFF;
-  int b = rgb & 0xFF;
-
-  return m_rgb_ntsc[r >> 2][g >> 2][b >> 2];
-}
-
@@ -20,26 +20,33 @@
 #include "../emucore/OSystem.hxx"
 #include "ale_screen.hpp"
 
+#include <memory>
+#include <vector>
+
 class PhosphorBlend {
   public:
     PhosphorBlend(OSystem *);
 
     void process(ALEScreen& screen);
 
+    /** Number of (even) NTSC colours indexing the blend table */
+    static const int NUM_COLOURS = 128;
+
   private:
-    void makeAveragePalette();
-    uInt8 getPhosphor(uInt8 v1, uInt8 v2);
-    uInt32 makeRGB(uInt8 r, uInt8 g, uInt8 b);
-    /** Converts a RGB value to an 8-bit format */
-    uInt8 rgbToNTSC(uInt32 rgb);
-    
+    /** Maps (current, previous) colour pairs, each halved, to the blended NTSC colour.
+        Padded so that 4-byte loads at any entry stay in bounds. */
+    typedef std::vector<uInt8> BlendTable;
+
+    /** Returns the blend table for the current palette, building it the first time
+        that palette is seen. Tables are shared by all environments of the process. */
+    static std::shared_ptr<const BlendTable> getBlendTable(const ColourPalette &palette);
+    static void makeBlendTable(const std::vector<uInt32> &colours, BlendTable &table);
+    static uInt8 getPhosphor(uInt8 v1, uInt8 v2);
+
   private:
     OSystem * m_osystem;
 
-    uInt8 m_rgb_ntsc[64][64][64];
-
-    uInt32 m_avg_palette[256][256];
-    uInt8 m_phosphor_blend_ratio;
+    std::shared_ptr<const BlendTable> m_blend_table;
 };
 
 #endif // __PHOSPHOR_BLEND_HPP__
@@ -0,0 +1,294 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  state_tree.cpp
+ *
+ *  A store of environment snapshots organized as a tree, for search agents.
+ *
+ **************************************************************************** */
+
+#include "state_tree.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+// Differences separated by at most this many equal bytes share a run, which is
+// no more expensive than the header of a new one
+static const size_t MAX_RUN_GAP = 1;
+static const size_t MAX_RUN_LENGTH = 8;
+static const size_t LONG_SKIP = 31;
+
+static const size_t DELTA_BLOCK_SIZE = 1 << 16;
+
+// RAM, and the fields which count cycles or frames, are predicted to change by as
+// much as in the parent's step
+static const size_t RAM_OFFSET = offsetof(ALESnapshot, system.riot.ram);
+static const size_t COUNTER_OFFSETS[] = {
+  offsetof(ALESnapshot, system.cycles),
+  offsetof(ALESnapshot, system.riot.cyclesWhenTimerSet),
+  offsetof(ALESnapshot, system.riot.cyclesWhenInterruptReset),
+  offsetof(ALESnapshot, system.tia.clockWhenFrameStarted),
+  offsetof(ALESnapshot, system.tia.clockStartDisplay),
+  offsetof(ALESnapshot, system.tia.clockStopDisplay),
+  offsetof(ALESnapshot, system.tia.clockAtLastUpdate),
+  offsetof(ALESnapshot, system.tia.VSYNCFinishClock),
+  offsetof(ALESnapshot, system.tia.lastHMOVEClock),
+  offsetof(ALESnapshot, system.tia.dumpDisabledCycle),
+  offsetof(ALESnapshot, frame_number),
+  offsetof(ALESnapshot, episode_frame_number)
+};
+
+// Varints hold 7 bits per byte, lowest first, with the top bit set on all but the last
+static size_t writeVarint(uInt8 *out, size_t value) {
+  size_t n = 0;
+  for (; value >= 0x80; value >>= 7) {
+    out[n++] = (uInt8)(0x80 | (value & 0x7F));
+  }
+  out[n++] = (uInt8)value;
+  return n;
+}
+
+static size_t readVarint(const uInt8 *&p) {
+  size_t value = 0;
+  for (int shift = 0; ; shift += 7) {
+    uInt8 byte = *p++;
+    value |= (size_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) return value;
+  }
+}
+
+StateTree::StateTree(int keyframe_interval):
+  m_keyframe_interval(keyframe_interval > 0 ? keyframe_interval : 1),
+  m_block_used(DELTA_BLOCK_SIZE),
+  m_current_node(NO_NODE) {
+  memset(&m_zero, 0, sizeof(m_zero));
+  memset(&m_current, 0, sizeof(m_current));
+  memset(&m_previous, 0, sizeof(m_previous));
+  memset(&m_predicted, 0, sizeof(m_predicted));
+}
+
+StateTree::~StateTree() {
+  for (size_t i = 0; i < m_blocks.size(); i++) {
+    delete[] m_blocks[i];
+  }
+}
+
+void StateTree::checkNode(NodeId node) const {
+  if (node >= m_nodes.size() || m_nodes[node].references == 0)
+    throw std::runtime_error("Invalid StateTree node");
+}
+
+StateTree::NodeId StateTree::add(const ALESnapshot& snapshot, NodeId parent) {
+  uInt32 depth = 0;
+  if (parent != NO_NODE) {
+    checkNode(parent);
+    depth = m_nodes[parent].depth + 1;
+  }
+
+  // Keyframes are stored as their difference with a zeroed snapshot
+  bool keyframe = depth % m_keyframe_interval == 0;
+  if (keyframe) {
+    encodeDelta(m_zero, snapshot);
+  } else {
+    reconstruct(parent);
+    predict();
+    encodeDelta(m_predicted, snapshot);
+  }
+
+  NodeId id;
+  if (!m_free.empty()) {
+    id = m_free.back();
+    m_free.pop_back();
+  } else {
+    id = m_nodes.size();
+    m_nodes.push_back(Node());
+  }
+  Node& node = m_nodes[id];
+  node.parent = parent;
+  node.depth = depth;
+  node.references = 1;
+  node.delta = storeDelta();
+  if (parent != NO_NODE) m_nodes[parent].references++;
+
+  memcpy(&m_previous, keyframe ? &snapshot : &m_current, sizeof(m_previous));
+  memcpy(&m_current, &snapshot, sizeof(m_current));
+  m_current_node = id;
+  return id;
+}
+
+void StateTree::get(NodeId node, ALESnapshot& snapshot) {
+  checkNode(node);
+  reconstruct(node);
+  memcpy(&snapshot, &m_current, sizeof(snapshot));
+}
+
+void StateTree::addReference(NodeId node) {
+  checkNode(node);
+  m_nodes[node].references++;
+}
+
+void StateTree::release(NodeId node) {
+  checkNode(node);
+
+  // Freeing a node releases its reference to its parent
+  while (node != NO_NODE && --m_nodes[node].references == 0) {
+    freeDelta(m_nodes[node].delta);
+    m_free.push_back(node);
+    if (node == m_current_node) m_current_node = NO_NODE;
+    node = m_nodes[node].parent;
+  }
+}
+
+size_t StateTree::memoryUsage() const {
+  size_t bytes = m_nodes.size() * sizeof(Node) + m_free.capacity() * sizeof(NodeId) +
+                 m_blocks.capacity() * sizeof(uInt8*) + m_blocks.size() * DELTA_BLOCK_SIZE;
+  for (size_t i = 0; i < m_free_deltas.size(); i++) {
+    bytes += m_free_deltas[i].capacity() * sizeof(uInt32);
+  }
+  return bytes;
+}
+
+void StateTree::reconstruct(NodeId node) {
+  // Walk up to the keyframe, or to the current node if it is on the way
+  m_path.clear();
+  NodeId n = node;
+  while (n != m_current_node) {
+    m_path.push_back(n);
+    if (isKeyframe(n)) break;
+    n = m_nodes[n].parent;
+  }
+
+  for (size_t i = m_path.size(); i-- > 0; ) {
+    if (isKeyframe(m_path[i])) {
+      memcpy(&m_current, &m_zero, sizeof(m_current));
+      applyDelta(m_nodes[m_path[i]].delta, m_current);
+      memcpy(&m_previous, &m_current, sizeof(m_previous));
+    } else {
+      predict();
+      applyDelta(m_nodes[m_path[i]].delta, m_predicted);
+      memcpy(&m_previous, &m_current, sizeof(m_previous));
+      memcpy(&m_current, &m_predicted, sizeof(m_current));
+    }
+  }
+  m_current_node = node;
+}
+
+void StateTree::predict() {
+  const uInt8 *current = (const uInt8*)&m_current;
+  const uInt8 *previous = (const uInt8*)&m_previous;
+  uInt8 *predicted = (uInt8*)&m_predicted;
+
+  memcpy(predicted, current, sizeof(m_predicted));
+  for (size_t i = RAM_OFFSET; i < RAM_OFFSET + sizeof(m_current.system.riot.ram); i++) {
+    predicted[i] = (uInt8)(2 * current[i] - previous[i]);
+  }
+  for (size_t i = 0; i < sizeof(COUNTER_OFFSETS) / sizeof(COUNTER_OFFSETS[0]); i++) {
+    uInt32 c, p;
+    memcpy(&c, current + COUNTER_OFFSETS[i], sizeof(c));
+    memcpy(&p, previous + COUNTER_OFFSETS[i], sizeof(p));
+    c += c - p;
+    memcpy(predicted + COUNTER_OFFSETS[i], &c, sizeof(c));
+  }
+}
+
+// Each run starts with a byte holding the number of equal bytes skipped since the
+// previous run and the run length minus one, in its top five and bottom three bits.
+// Skips of LONG_SKIP bytes or more store LONG_SKIP, followed by the rest as a varint.
+void StateTree::encodeDelta(const ALESnapshot& base, const ALESnapshot& snapshot) {
+  const uInt8 *a = (const uInt8*)&base;
+  const uInt8 *b = (const uInt8*)&snapshot;
+  const size_t n = sizeof(ALESnapshot);
+
+  m_encoded.clear();
+  size_t end = 0; // End of the previous run
+  size_t i = 0;
+  while (true) {
+    while (i < n && a[i] == b[i]) i++;
+    if (i == n) break;
+
+    // Extend the run over differences at most MAX_RUN_GAP bytes apart
+    size_t start = i;
+    size_t last = i;
+    while (i < n && i - start < MAX_RUN_LENGTH && i - last <= MAX_RUN_GAP) {
+      if (a[i] != b[i]) last = i;
+      i++;
+    }
+    i = last + 1;
+
+    size_t skip = start - end;
+    m_encoded.push_back((uInt8)((std::min(skip, LONG_SKIP) << 3) | (i - start - 1)));
+    if (skip >= LONG_SKIP) {
+      uInt8 varint[10];
+      m_encoded.insert(m_encoded.end(), varint, varint + writeVarint(varint, skip - LONG_SKIP));
+    }
+    m_encoded.insert(m_encoded.end(), b + start, b + i);
+    end = i;
+  }
+}
+
+void StateTree::applyDelta(uInt32 delta, ALESnapshot& snapshot) const {
+  uInt8 *dst = (uInt8*)&snapshot;
+  const uInt8 *p = deltaData(delta);
+  size_t size = readVarint(p);
+  const uInt8 *end = p + size;
+
+  size_t pos = 0;
+  while (p < end) {
+    uInt8 header = *p++;
+    size_t skip = header >> 3;
+    size_t length = (header & 0x07) + 1;
+    if (skip == LONG_SKIP) skip += readVarint(p);
+    pos += skip;
+    memcpy(dst + pos, p, length);
+    p += length;
+    pos += length;
+  }
+}
+
+// A stored delta is its size as a varint, followed by the encoded runs
+uInt32 StateTree::storeDelta() {
+  uInt8 prefix[10];
+  size_t prefix_size = writeVarint(prefix, m_encoded.size());
+  size_t size = prefix_size + m_encoded.size();
+
+  uInt32 delta;
+  if (size < m_free_deltas.size() && !m_free_deltas[size].empty()) {
+    delta = m_free_deltas[size].back();
+    m_free_deltas[size].pop_back();
+  } else {
+    // Deltas do not straddle blocks; the end of a full block is left unused
+    if (m_block_used + size > DELTA_BLOCK_SIZE) {
+      m_blocks.push_back(new uInt8[DELTA_BLOCK_SIZE]);
+      m_block_used = 0;
+    }
+    delta = (uInt32)((m_blocks.size() - 1) * DELTA_BLOCK_SIZE + m_block_used);
+    m_block_used += size;
+  }
+
+  uInt8 *data = deltaData(delta);
+  memcpy(data, prefix, prefix_size);
+  if (!m_encoded.empty()) memcpy(data + prefix_size, &m_encoded[0], m_encoded.size());
+  return delta;
+}
+
+void StateTree::freeDelta(uInt32 delta) {
+  const uInt8 *p = deltaData(delta);
+  const uInt8 *data = p;
+  size_t size = readVarint(p);
+  size += p - data;
+  if (size >= m_free_deltas.size()) m_free_deltas.resize(size + 1);
+  m_free_deltas[size].push_back(delta);
+}
+
+uInt8 *StateTree::deltaData(uInt32 delta) const {
+  return m_blocks[delta / DELTA_BLOCK_SIZE] + delta % DELTA_BLOCK_SIZE;
+}
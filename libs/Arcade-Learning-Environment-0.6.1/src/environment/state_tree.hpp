@@ -0,0 +1,124 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  state_tree.hpp
+ *
+ *  A store of environment snapshots organized as a tree, for search agents.
+ *
+ **************************************************************************** */
+
+#ifndef __STATE_TREE_HPP__
+#define __STATE_TREE_HPP__
+
+#include "ale_state.hpp"
+
+#include <deque>
+#include <vector>
+
+/**
+   Holds ALESnapshots as the nodes of a search tree. A node only stores the bytes
+   of its snapshot which differ from a prediction made from its parent's, since one
+   emulated step changes a few dozen bytes of RAM and registers. The prediction
+   assumes that RAM and the cycle and frame counters change by as much as they did
+   in the parent's own step, which holds for timers and steadily moving objects.
+   Every keyframe_interval levels a node stores its whole snapshot instead, which
+   bounds the cost of reconstructing one.
+
+   Nodes are reference counted. A node holds a reference to its parent, so it can
+   be reconstructed for as long as it is alive, and it is freed together with the
+   ancestors only it kept alive when its last reference is released.
+ */
+class StateTree {
+  public:
+    typedef uInt32 NodeId;
+    static const NodeId NO_NODE = 0xFFFFFFFF;
+
+    StateTree(int keyframe_interval = 64);
+    ~StateTree();
+
+    /** Adds a snapshot as a child of 'parent', or as a root with NO_NODE. The new node
+        starts with one reference, owned by the caller. Adding a child of the node last
+        added or reconstructed is the cheapest. */
+    NodeId add(const ALESnapshot& snapshot, NodeId parent = NO_NODE);
+
+    /** Reconstructs the snapshot of a node. This starts from the node last added or
+        reconstructed when it is an ancestor of 'node' below its keyframe, and from
+        that keyframe otherwise. */
+    void get(NodeId node, ALESnapshot& snapshot);
+
+    /** Takes and releases a reference to a node. */
+    void addReference(NodeId node);
+    void release(NodeId node);
+
+    NodeId parent(NodeId node) const { return m_nodes[node].parent; }
+    uInt32 depth(NodeId node) const { return m_nodes[node].depth; }
+
+    /** Number of live nodes. */
+    size_t size() const { return m_nodes.size() - m_free.size(); }
+
+    /** Bytes held by the tree, including the space of freed nodes kept for reuse. */
+    size_t memoryUsage() const;
+
+  private:
+    struct Node {
+      NodeId parent;
+      uInt32 depth;
+      uInt32 references; // 0 for a free node
+      uInt32 delta;      // Where the delta is in the delta blocks, see storeDelta()
+    };
+
+    // The tree owns the delta blocks
+    StateTree(const StateTree&);
+    StateTree& operator=(const StateTree&);
+
+    void checkNode(NodeId node) const;
+    bool isKeyframe(NodeId node) const {
+      return m_nodes[node].depth % m_keyframe_interval == 0;
+    }
+
+    /** Brings m_current to the snapshot of 'node'. */
+    void reconstruct(NodeId node);
+
+    /** Predicts the snapshot of a child of m_current_node into m_predicted. */
+    void predict();
+
+    /** Encodes the bytes of 'snapshot' which differ from 'base' into m_encoded. */
+    void encodeDelta(const ALESnapshot& base, const ALESnapshot& snapshot);
+    void applyDelta(uInt32 delta, ALESnapshot& snapshot) const;
+
+    /** Copies m_encoded into the delta blocks, and frees a stored delta. */
+    uInt32 storeDelta();
+    void freeDelta(uInt32 delta);
+    uInt8 *deltaData(uInt32 delta) const;
+
+    int m_keyframe_interval;
+
+    // A deque grows without moving the nodes or leaving up to half of them unused
+    std::deque<Node> m_nodes;
+    std::vector<NodeId> m_free; // Free slots of m_nodes
+
+    // Deltas are packed in large blocks, which saves the allocator's overhead on
+    // each of them; freed deltas are reused by deltas of the same size
+    std::vector<uInt8*> m_blocks;
+    size_t m_block_used; // Bytes used in the last block
+    std::vector<std::vector<uInt32> > m_free_deltas; // Freed deltas, by size
+
+    ALESnapshot m_zero;      // The base of keyframes
+    ALESnapshot m_current;   // The snapshot of m_current_node
+    ALESnapshot m_previous;  // The snapshot of its parent, or itself for a keyframe
+    ALESnapshot m_predicted;
+    NodeId m_current_node;
+
+    // Scratch space
+    std::vector<uInt8> m_encoded;
+    std::vector<NodeId> m_path;
+};
+
+#endif // __STATE_TREE_HPP__
@@ -17,7 +17,10 @@
 
 #include "stella_environment.hpp"
 #include "../emucore/m6502/src/System.hxx"
+#include <algorithm>
+#include <cstring>
 #include <sstream>
+#include <stdexcept>
 
 StellaEnvironment::StellaEnvironment(OSystem* osystem, RomSettings* settings):
   m_osystem(osystem),
@@ -25,8 +28,11 @@ StellaEnvironment::StellaEnvironment(OSystem* osystem, RomSettings* settings):
   m_phosphor_blend(osystem),  
   m_screen(m_osystem->console().mediaSource().height(),
         m_osystem->console().mediaSource().width()),
+  m_ram(m_osystem->console().riot().ram()),
+  m_screen_dirty(false),
   m_player_a_action(PLAYER_A_NOOP),
-  m_player_b_action(PLAYER_B_NOOP) {
+  m_player_b_action(PLAYER_B_NOOP),
+  m_num_replay_frames(0) {
 
   // Determine whether this is a paddle-based game
   if (m_osystem->console().properties().get(Controller_Left) == "PADDLES" ||
@@ -43,6 +49,13 @@ StellaEnvironment::StellaEnvironment(OSystem* osystem, RomSettings* settings):
   m_colour_averaging = m_osystem->settings().getBool("color_averaging");
 
   m_repeat_action_probability = m_osystem->settings().getFloat("repeat_action_probability");
+
+  m_reset_cache = m_osystem->settings().getBool("reset_cache");
+  m_reset_cache_size = std::max(m_osystem->settings().getInt("reset_cache_size"), 1);
+  m_reset_clock = 0;
+  m_reset_cache_hits = 0;
+  m_reset_cache_misses = 0;
+  m_max_num_noop_starts = m_osystem->settings().getInt("max_num_noop_starts");
   
   m_frame_skip = m_osystem->settings().getInt("frame_skip");
   if (m_frame_skip < 1) {
@@ -50,13 +63,52 @@ StellaEnvironment::StellaEnvironment(OSystem* osystem, RomSettings* settings):
     m_frame_skip = 1;
   }
 
-  // If so desired, we record all emulated frames to a given directory 
+  std::string renderMode = m_osystem->settings().getString("render_mode");
+  if (renderMode == "last") {
+    m_render_mode = RENDER_LAST;
+  } else if (renderMode == "never") {
+    m_render_mode = RENDER_NEVER;
+  } else {
+    if (renderMode != "all") {
+      ale::Logger::Warning << "Warning: unknown render mode '" << renderMode
+                           << "'. Rendering all frames." << std::endl;
+    }
+    m_render_mode = RENDER_ALL;
+  }
+
+  // If so desired, we record all emulated frames to a given directory, or to
+  // a single episode file. Frames are encoded on a background thread.
   std::string recordDir = m_osystem->settings().getString("record_screen_dir");
-  if (!recordDir.empty()) {
+  std::string recordEpisode = m_osystem->settings().getString("record_episode_file");
+  int compression = m_osystem->settings().getInt("record_screen_compression");
+  if (!recordEpisode.empty()) {
+    ale::Logger::Info << "Recording screens to episode file: " << recordEpisode << std::endl;
+    if (!recordDir.empty()) {
+      ale::Logger::Warning << "Warning: record_episode_file is set, ignoring record_screen_dir."
+                           << std::endl;
+    }
+    m_screen_exporter.reset(new ScreenExporter(m_osystem->colourPalette(), recordEpisode,
+                                               compression, 64, ScreenExporter::FORMAT_EPISODE));
+  } else if (!recordDir.empty()) {
     ale::Logger::Info << "Recording screens to directory: " << recordDir << std::endl;
     
     // Create the screen exporter
-    m_screen_exporter.reset(new ScreenExporter(m_osystem->colourPalette(), recordDir)); 
+    m_screen_exporter.reset(new ScreenExporter(m_osystem->colourPalette(), recordDir, compression));
+  }
+
+  if (m_screen_exporter.get() != NULL) {
+    // Every frame gets saved, so every frame must be drawn
+    if (m_render_mode != RENDER_ALL) {
+      ale::Logger::Warning << "Warning: recording screens, rendering all frames." << std::endl;
+      m_render_mode = RENDER_ALL;
+    }
+  }
+
+  // Sound is produced as frames are emulated: the frames emulated again at the end of an
+  // episode under render_mode 'last' would be played and recorded twice
+  if (m_osystem->settings().getBool("sound") && m_render_mode == RENDER_LAST) {
+    ale::Logger::Warning << "Warning: sound is enabled, rendering all frames." << std::endl;
+    m_render_mode = RENDER_ALL;
   }
 }
 
@@ -69,6 +121,25 @@ void StellaEnvironment::reset() {
   // Reset the emulator
   m_osystem->console().system().reset();
 
+  if (m_reset_cache)
+    restoreResetSequence();
+  else
+    emulateResetSequence();
+
+  // Randomize the start of the episode
+  if (m_max_num_noop_starts > 0) {
+    int noops = m_osystem->rng().next() % (m_max_num_noop_starts + 1);
+    if (noops > 0) {
+      emulate(PLAYER_A_NOOP, PLAYER_B_NOOP, noops);
+      m_state.incrementFrame(noops);
+    }
+  }
+
+  if (m_observation_pipeline.get() != NULL)
+    m_observation_pipeline->reset();
+}
+
+void StellaEnvironment::emulateResetSequence() {
   // NOOP for 60 steps in the deterministic environment setting, or some random amount otherwise 
   int noopSteps;
   noopSteps = 60;
@@ -91,6 +162,64 @@ void StellaEnvironment::reset() {
   }
 }
 
+void StellaEnvironment::restoreResetSequence() {
+  // Consoles whose state does not fit in a snapshot are not cached
+  if (!m_osystem->console().system().saveState(m_power_on_snapshot)) {
+    emulateResetSequence();
+    m_reset_cache_misses++;
+    return;
+  }
+
+  ResetKey key(m_power_on_snapshot.riot.timer, m_state.getCurrentMode(),
+               m_state.getDifficulty());
+  MediaSource& mediaSource = m_osystem->console().mediaSource();
+  size_t frame_size = mediaSource.width() * mediaSource.height();
+
+  std::map<ResetKey, ResetState>::iterator it = m_reset_states.find(key);
+  if (it != m_reset_states.end()) {
+    ResetState& cached = it->second;
+    cached.last_used = ++m_reset_clock;
+    m_reset_cache_hits++;
+    // Frame numbers go on from the current ones; the sequence may count frames (pressSelect)
+    int frame_number = m_state.getFrameNumber();
+    ALESnapshot& snapshot = cached.snapshot;
+    int cached_frame_number = snapshot.frame_number;
+    snapshot.frame_number = frame_number + snapshot.episode_frame_number;
+    m_state.load(m_osystem, m_settings, snapshot);
+    snapshot.frame_number = cached_frame_number;
+
+    memcpy(mediaSource.currentFrameBuffer(), &cached.current_frame[0], frame_size);
+    memcpy(mediaSource.previousFrameBuffer(), &cached.previous_frame[0], frame_size);
+    m_screen_dirty = true;
+
+    m_player_a_action = PLAYER_A_NOOP;
+    m_player_b_action = PLAYER_B_NOOP;
+    return;
+  }
+
+  emulateResetSequence();
+  m_reset_cache_misses++;
+
+  ResetState state;
+  if (!m_state.save(m_osystem, m_settings, m_serializer, state.snapshot))
+    return;
+  state.current_frame.assign(mediaSource.currentFrameBuffer(),
+                             mediaSource.currentFrameBuffer() + frame_size);
+  state.previous_frame.assign(mediaSource.previousFrameBuffer(),
+                              mediaSource.previousFrameBuffer() + frame_size);
+  state.last_used = ++m_reset_clock;
+
+  // Drop the least recently used state to make room
+  if (m_reset_states.size() >= m_reset_cache_size) {
+    std::map<ResetKey, ResetState>::iterator oldest = m_reset_states.begin();
+    for (it = m_reset_states.begin(); it != m_reset_states.end(); ++it) {
+      if (it->second.last_used < oldest->second.last_used) oldest = it;
+    }
+    m_reset_states.erase(oldest);
+  }
+  m_reset_states.insert(std::make_pair(key, state));
+}
+
 /** Save/restore the environment state. */
 void StellaEnvironment::save() {
   // Store the current state into a new object
@@ -108,15 +237,35 @@ void StellaEnvironment::load() {
 }
 
 ALEState StellaEnvironment::cloneState() {
-  return m_state.save(m_osystem, m_settings, m_cartridge_md5, false);
+  ALEState state;
+  cloneState(state);
+  return state;
+}
+
+void StellaEnvironment::cloneState(ALEState& state) {
+  m_state.save(m_osystem, m_settings, m_cartridge_md5, false, m_serializer, state);
 }
 
 void StellaEnvironment::restoreState(const ALEState& target_state) {
   m_state.load(m_osystem, m_settings, m_cartridge_md5, target_state, false);
 }
 
+bool StellaEnvironment::cloneState(ALESnapshot& snapshot) {
+  return m_state.save(m_osystem, m_settings, m_serializer, snapshot);
+}
+
+void StellaEnvironment::restoreState(const ALESnapshot& snapshot) {
+  m_state.load(m_osystem, m_settings, snapshot);
+}
+
 ALEState StellaEnvironment::cloneSystemState() {
-  return m_state.save(m_osystem, m_settings, m_cartridge_md5, true);
+  ALEState state;
+  cloneSystemState(state);
+  return state;
+}
+
+void StellaEnvironment::cloneSystemState(ALEState& state) {
+  m_state.save(m_osystem, m_settings, m_cartridge_md5, true, m_serializer, state);
 }
 
 void StellaEnvironment::restoreSystemState(const ALEState& target_state) {
@@ -164,15 +313,42 @@ reward_t StellaEnvironment::act(Action player_a_action, Action player_b_action)
 
     // Similarly record screen as needed
     if (m_screen_exporter.get() != NULL)
-        m_screen_exporter->saveNext(m_screen);
+        m_screen_exporter->saveNext(getScreen());
 
     // Use the stored actions, which may or may not have changed this frame
-    sum_rewards += oneStepAct(m_player_a_action, m_player_b_action);
+    sum_rewards += oneStepAct(m_player_a_action, m_player_b_action, m_frame_skip - 1 - i);
   }
 
+  if (m_observation_pipeline.get() != NULL)
+    m_observation_pipeline->process();
+
   return sum_rewards;
 }
 
+void StellaEnvironment::replayFrames() {
+  // The screen shows the terminal frame, and the one before it with colour averaging or
+  // max pooling; frames drawn already need not be emulated again
+  int first = m_num_replay_frames - std::min(m_num_replay_frames, isFrameRendered(1) ? 2 : 1);
+  while (first < m_num_replay_frames && m_replay_frames[first % 2].drawn)
+    first++;
+
+  if (first == m_num_replay_frames - 1) {
+    // Drawing one frame again swaps the frame buffers back, so the frame drawn before it
+    // must also be in the buffer which becomes the previous one
+    MediaSource& mediaSource = m_osystem->console().mediaSource();
+    memcpy(mediaSource.currentFrameBuffer(), mediaSource.previousFrameBuffer(),
+           mediaSource.width() * mediaSource.height());
+  }
+  if (first < m_num_replay_frames)
+    m_state.load(m_osystem, m_settings, m_replay_frames[first % 2].snapshot);
+  for (int i = first; i < m_num_replay_frames; i++) {
+    const ReplayFrame& frame = m_replay_frames[i % 2];
+    emulate(frame.player_a_action, frame.player_b_action, 1, m_num_replay_frames - 1 - i);
+    m_state.incrementFrame();
+  }
+  m_num_replay_frames = 0;
+}
+
 /** This functions emulates a push on the reset button of the console */
 void StellaEnvironment::softReset() {
   emulate(RESET, PLAYER_B_NOOP, m_num_reset_steps);
@@ -184,7 +360,8 @@ void StellaEnvironment::softReset() {
 
 /** Applies the given actions (e.g. updating paddle positions when the paddle is used)
   *  and performs one simulation step in Stella. */
-reward_t StellaEnvironment::oneStepAct(Action player_a_action, Action player_b_action) {
+reward_t StellaEnvironment::oneStepAct(Action player_a_action, Action player_b_action,
+                                       size_t frames_after) {
   // Once in a terminal state, refuse to go any further (special actions must be handled
   //  outside of this environment; in particular reset() should be called rather than passing
   //  RESET or SYSTEM_RESET.
@@ -194,11 +371,30 @@ reward_t StellaEnvironment::oneStepAct(Action player_a_action, Action player_b_a
   // Convert illegal actions into NOOPs; actions such as reset are always legal
   noopIllegalActions(player_a_action, player_b_action);
   
+  // Under render_mode 'last', the episode may end before the last frame of an act(), when
+  // the frames the screen shows may not have been drawn; they are saved to be emulated again
+  if (m_render_mode != RENDER_LAST || frames_after == 0) {
+    m_num_replay_frames = 0;
+  } else {
+    ReplayFrame& frame = m_replay_frames[m_num_replay_frames % 2];
+    if (m_state.save(m_osystem, m_settings, m_serializer, frame.snapshot)) {
+      frame.player_a_action = player_a_action;
+      frame.player_b_action = player_b_action;
+      frame.drawn = isFrameRendered(frames_after);
+      m_num_replay_frames++;
+    } else {
+      m_num_replay_frames = 0;
+    }
+  }
+
   // Emulate in the emulator
-  emulate(player_a_action, player_b_action);
+  emulate(player_a_action, player_b_action, 1, frames_after);
   // Increment the number of frames seen so far
   m_state.incrementFrame();
 
+  if (m_num_replay_frames > 0 && isTerminal())
+    replayFrames();
+
   return m_settings->getReward();
 }
 
@@ -210,11 +406,15 @@ bool StellaEnvironment::isTerminal() const {
 
 void StellaEnvironment::pressSelect(size_t num_steps) {
   m_state.pressSelect(m_osystem->event());
+  MediaSource& mediaSource = m_osystem->console().mediaSource();
   for (size_t t = 0; t < num_steps; t++) {
-    m_osystem->console().mediaSource().update();
+    // One more step is emulated below before the screen is observed
+    if (m_render_mode != RENDER_ALL)
+      mediaSource.setRendering(isFrameRendered(num_steps - t));
+    mediaSource.update();
   }
-  processScreen();
-  processRAM();
+  if (m_render_mode == RENDER_ALL)
+    m_screen_dirty = true;
   emulate(PLAYER_A_NOOP, PLAYER_B_NOOP);
   m_state.incrementFrame();
 }
@@ -227,8 +427,10 @@ void StellaEnvironment::setMode(game_mode_t value) {
   m_state.setCurrentMode(value);
 }
 
-void StellaEnvironment::emulate(Action player_a_action, Action player_b_action, size_t num_steps) {
+void StellaEnvironment::emulate(Action player_a_action, Action player_b_action, size_t num_steps,
+                                size_t frames_after) {
   Event* event = m_osystem->event();
+  MediaSource& mediaSource = m_osystem->console().mediaSource();
   
   // Handle paddles separately: we have to manually update the paddle positions at each step
   if (m_use_paddles) {
@@ -237,7 +439,9 @@ void StellaEnvironment::emulate(Action player_a_action, Action player_b_action,
       // Update paddle position at every step
       m_state.applyActionPaddles(event, player_a_action, player_b_action);
 
-      m_osystem->console().mediaSource().update();
+      if (m_render_mode != RENDER_ALL)
+        mediaSource.setRendering(isFrameRendered(num_steps - 1 - t + frames_after));
+      mediaSource.update();
       m_settings->step(m_osystem->console().system());
     }
   }
@@ -246,14 +450,50 @@ void StellaEnvironment::emulate(Action player_a_action, Action player_b_action,
     m_state.setActionJoysticks(event, player_a_action, player_b_action);
 
     for (size_t t = 0; t < num_steps; t++) {
-      m_osystem->console().mediaSource().update();
+      if (m_render_mode != RENDER_ALL)
+        mediaSource.setRendering(isFrameRendered(num_steps - 1 - t + frames_after));
+      mediaSource.update();
       m_settings->step(m_osystem->console().system());
     }
   }
 
-  // Parse screen and RAM into their respective data structures
-  processScreen();
-  processRAM();
+  // The screen is processed when next requested; the frame buffers are left untouched
+  // until the next emulated frame. Intermediate frames of a skipped sequence are not
+  // looked at unless every frame is rendered
+  if (m_render_mode == RENDER_ALL || (m_render_mode == RENDER_LAST && frames_after == 0))
+    m_screen_dirty = true;
+}
+
+bool StellaEnvironment::isFrameRendered(size_t frames_after) const {
+  switch (m_render_mode) {
+    case RENDER_NEVER:
+      return false;
+    case RENDER_LAST:
+      // Colour averaging and max pooling look at the last two frames
+      if (m_colour_averaging || (m_observation_pipeline.get() != NULL &&
+                                 m_observation_pipeline->usesPreviousFrame()))
+        return frames_after < 2;
+      return frames_after < 1;
+    default:
+      return true;
+  }
+}
+
+void StellaEnvironment::setObservationPipeline(int height, int width, int stack_size,
+                                               bool max_pool) {
+  if (stack_size == 0) {
+    m_observation_pipeline.reset();
+    return;
+  }
+  // The pipeline reads the frame buffers, which are left blank with render_mode 'never',
+  // and does its own maximum over frames instead of colour averaging
+  if (m_render_mode == RENDER_NEVER)
+    throw std::runtime_error("The observation pipeline needs render_mode 'last' or 'all'");
+  if (m_colour_averaging)
+    throw std::runtime_error("The observation pipeline does not support color_averaging");
+  m_observation_pipeline.reset(
+      new ObservationPipeline(m_osystem, height, width, stack_size, max_pool));
+  m_observation_pipeline->reset();
 }
 
 /** Accessor methods for the environment state. */
@@ -269,6 +509,14 @@ std::unique_ptr<StellaEnvironmentWrapper> StellaEnvironment::getWrapper() {
     return std::unique_ptr<StellaEnvironmentWrapper>(new StellaEnvironmentWrapper(*this));
 }
 
+const ALEScreen& StellaEnvironment::getScreen() {
+  if (m_screen_dirty) {
+    processScreen();
+    m_screen_dirty = false;
+  }
+  return m_screen;
+}
+
 void StellaEnvironment::processScreen() {
   if (m_colour_averaging) {
     // Perform phosphor averaging; the blender stores its result in the given screen
@@ -280,10 +528,3 @@ void StellaEnvironment::processScreen() {
       m_osystem->console().mediaSource().currentFrameBuffer(), m_screen.arraySize());
   }
 }
-
-void StellaEnvironment::processRAM() {
-  // Copy RAM over
-  for (size_t i = 0; i < m_ram.size(); i++)
-    *m_ram.byte(i) = m_osystem->console().system().peek(i + 0x80); 
-}
-
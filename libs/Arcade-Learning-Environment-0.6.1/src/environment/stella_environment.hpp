@@ -22,22 +22,32 @@
 #include "ale_screen.hpp"
 #include "ale_state.hpp"
 #include "phosphor_blend.hpp"
+#include "observation_pipeline.hpp"
 #include "stella_environment_wrapper.hpp"
 #include "../emucore/Event.hxx"
 #include "../emucore/OSystem.hxx"
+#include "../emucore/Serializer.hxx"
 #include "../games/RomSettings.hpp"
 #include "../common/Constants.h"
 #include "../common/Log.hpp"
 #include "../common/ScreenExporter.hpp"
 
+#include <cstdint>
+#include <map>
 #include <stack>
 #include <memory>
+#include <tuple>
+#include <vector>
 
 class StellaEnvironment {
   public:
     StellaEnvironment(OSystem * system, RomSettings * settings);
 
-    /** Resets the system to its start state. */
+    /** Resets the system to its start state. With the reset_cache setting, the state reached
+        by the reset sequence is remembered and later resets restore it instead of emulating
+        the sequence again (up to reset_cache_size states, least recently used first out);
+        with max_num_noop_starts > 0, a random number of NOOP frames up to that value is
+        then emulated. */
     void reset();
 
     /** Save/restore the environment state onto the stack. */
@@ -47,12 +57,24 @@ class StellaEnvironment {
     /** Returns a copy of the current emulator state. Note that this doesn't include
         pseudorandomness, so that clone/restoreState are suitable for planning. */
     ALEState cloneState();
+    /** Same as cloneState(), but stores the copy into 'state', reusing the memory it holds. */
+    void cloneState(ALEState& state);
     /** Restores a previously saved copy of the state. */
     void restoreState(const ALEState&);
 
+    /** Copies the current emulator state into a fixed-size snapshot, which is much cheaper
+        than cloneState(). Returns false if the console state does not fit in a snapshot
+        (e.g. cartridges with extra RAM), in which case cloneState() must be used instead.
+        Like cloneState(), this doesn't include pseudorandomness. */
+    bool cloneState(ALESnapshot& snapshot);
+    /** Restores a state previously copied into a snapshot. */
+    void restoreState(const ALESnapshot& snapshot);
+
     /** Returns a copy of the current emulator state. This includes RNG state information, and
         more generally should lead to exactly reproducibility. */
     ALEState cloneSystemState();
+    /** Same as cloneSystemState(), but stores the copy into 'state', reusing its memory. */
+    void cloneSystemState(ALEState& state);
     /** Restores a previously saved copy of the state, including RNG state information. */
     void restoreSystemState(const ALEState&);
 
@@ -89,22 +111,65 @@ class StellaEnvironment {
     void setState(const ALEState & state);
     const ALEState &getState() const;
 
-    /** Returns the current screen after processing (e.g. colour averaging) */
-    const ALEScreen &getScreen() const { return m_screen; }
+    /** Returns the current screen after processing (e.g. colour averaging). With render_mode
+        'never' the screen is never updated; with 'last' the frame which ends the episode is
+        drawn, even before the last frame of an act(). The screen is only copied out of
+        the emulator when first requested after a step. */
+    const ALEScreen &getScreen();
+    /** Returns a read-only view over the emulator RAM, which always reflects its current
+        contents; use ALERAM::snapshot() to keep a copy. */
     const ALERAM &getRAM() const { return m_ram; }
 
+    /** Attaches an observation pipeline, which processes the screen at the end of each act()
+        (see ObservationPipeline); a stack size of 0 detaches it. The stack starts out filled
+        with the current screen, and is refilled on every reset(). Throws std::runtime_error
+        with render_mode 'never' or color_averaging set, or for an empty
+        observation or a negative stack size. */
+    void setObservationPipeline(int height, int width, int stack_size, bool max_pool);
+    /** Returns the attached observation pipeline, or NULL. */
+    const ObservationPipeline *getObservationPipeline() const { return m_observation_pipeline.get(); }
+
+    /** Number of resets which restored a cached reset state, and which emulated the reset
+        sequence, since the environment was created (see reset()). */
+    int getNumResetCacheHits() const { return m_reset_cache_hits; }
+    int getNumResetCacheMisses() const { return m_reset_cache_misses; }
+
     int getFrameNumber() const { return m_state.getFrameNumber(); }
     int getEpisodeFrameNumber() const { return m_state.getEpisodeFrameNumber(); }
 
+    /** The actions currently repeated with repeat_action_probability. They are not part of
+        ALEState, so replaying from a cloned state must restore them separately. */
+    void getStickyActions(Action &player_a_action, Action &player_b_action) const {
+      player_a_action = m_player_a_action;
+      player_b_action = m_player_b_action;
+    }
+    void setStickyActions(Action player_a_action, Action player_b_action) {
+      m_player_a_action = player_a_action;
+      m_player_b_action = player_b_action;
+    }
+
     /** Returns a wrapper providing #include-free access to our methods. */ 
     std::unique_ptr<StellaEnvironmentWrapper> getWrapper();
 
   private:
-    /** This applies an action exactly one time step. Helper function to act(). */
-    reward_t oneStepAct(Action player_a_action, Action player_b_action);
+    /** This applies an action exactly one time step. Helper function to act().
+      *  'frames_after' is the number of steps act() will still emulate after this one. If
+      *  the frame ends the episode, replayFrames() draws what the screen shows. */
+    reward_t oneStepAct(Action player_a_action, Action player_b_action,
+                        size_t frames_after = 0);
+
+    /** Emulates again, drawn, the frames at the end of an episode which the screen shows but
+      *  were not drawn. */
+    void replayFrames();
+
+    /** Actually emulates the emulator for a given number of steps. 'frames_after' is the
+      *  number of steps that will be emulated before the screen is next observed. */
+    void emulate(Action player_a_action, Action player_b_action, size_t num_steps = 1,
+                 size_t frames_after = 0);
 
-    /** Actually emulates the emulator for a given number of steps. */
-    void emulate(Action player_a_action, Action player_b_action, size_t num_steps = 1);
+    /** Returns whether a frame followed by 'frames_after' more steps before the next
+      *  observation needs to be drawn, according to the render mode. */
+    bool isFrameRendered(size_t frames_after) const;
 
     /** Drops illegal actions, such as the fire button in skiing. Note that this is different
       *   from the minimal set of actions. */
@@ -112,26 +177,43 @@ class StellaEnvironment {
 
     /** Processes the current emulator screen and saves it in m_screen */
     void processScreen();
-    /** Processes the emulator RAM and saves it in m_ram */
-    void processRAM();
+
+    /** Emulates the frames that follow the power-on of the console in reset(): NOOPs, soft
+      *  resets, mode selection and the starting actions of the game. */
+    void emulateResetSequence();
+
+    /** Restores the state emulateResetSequence() reached from the same power-on state, if it
+      *  is cached; otherwise emulates the sequence and caches its result when possible. */
+    void restoreResetSequence();
 
   private:
+    /** Which emulated frames are drawn by the TIA (see the render_mode setting) */
+    enum RenderMode {
+      RENDER_ALL,   // Every frame
+      RENDER_LAST,  // Only the frames processScreen() looks at
+      RENDER_NEVER  // No frame; the screen is never updated
+    };
+
     OSystem *m_osystem;
     RomSettings *m_settings;
     PhosphorBlend m_phosphor_blend; // For performing phosphor colour averaging, if so desired
+    std::unique_ptr<ObservationPipeline> m_observation_pipeline; // Preprocessed observations, if any
     std::string m_cartridge_md5; // Necessary for saving and loading emulator state
 
     std::stack<ALEState> m_saved_states; // States are saved on a stack
+    Serializer m_serializer; // Reused by cloneState() and friends
     
     ALEState m_state; // Current environment state    
     ALEScreen m_screen; // The current ALE screen (possibly colour-averaged)
-    ALERAM m_ram; // The current ALE RAM
+    ALERAM m_ram; // View over the emulator RAM
+    bool m_screen_dirty; // Whether m_screen lags behind the emulator
 
     bool m_use_paddles;  // Whether this game uses paddles
     
     /** Parameters loaded from Settings. */
     int m_num_reset_steps; // Number of RESET frames per reset
     bool m_colour_averaging; // Whether to average frames
+    RenderMode m_render_mode; // Which frames are drawn
     int m_max_num_frames_per_episode; // Maxmimum number of frames per episode 
     size_t m_frame_skip; // How many frames to emulate per act()
     float m_repeat_action_probability; // Stochasticity of the environment
@@ -139,6 +221,36 @@ class StellaEnvironment {
 
     // The last actions taken by our players
     Action m_player_a_action, m_player_b_action;
+
+    /** A frame emulated by act() under render_mode 'last', which can be emulated again */
+    struct ReplayFrame {
+      ALESnapshot snapshot; // The state before the frame
+      Action player_a_action, player_b_action;
+      bool drawn; // Whether the frame was drawn
+    };
+    ReplayFrame m_replay_frames[2]; // The last two frames of the current act()
+    int m_num_replay_frames; // Frames saved by this act(), the last one at index (n - 1) % 2
+
+    /** The state at the end of the reset sequence, with the frames it leaves behind */
+    struct ResetState {
+      ALESnapshot snapshot;
+      std::vector<uInt8> current_frame;
+      std::vector<uInt8> previous_frame;
+      uint64_t last_used; // Value of m_reset_clock when last restored
+    };
+    /** What the reset sequence depends on: the RIOT timer drawn at power-on (the only
+      *  pseudorandom part of a reset), the game mode and the difficulty. Like the console,
+      *  games clear their RAM on start-up, so what it held before is not part of the key. */
+    typedef std::tuple<uInt32, game_mode_t, difficulty_t> ResetKey;
+
+    bool m_reset_cache; // Whether reset() restores cached states
+    size_t m_reset_cache_size; // Maximum number of cached reset states
+    int m_max_num_noop_starts; // Maximum number of NOOP frames after a reset
+    std::map<ResetKey, ResetState> m_reset_states; // Cached ends of the reset sequence
+    uint64_t m_reset_clock; // Number of cached resets, to find the least recently used
+    int m_reset_cache_hits; // Resets which restored a cached state
+    int m_reset_cache_misses; // Resets which emulated the reset sequence with reset_cache
+    SystemSnapshot m_power_on_snapshot; // The console state right after power-on
 };
 
 #endif // __STELLA_ENVIRONMENT_HPP__
@@ -0,0 +1,171 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *
+ * RomDescriptor.hpp
+ *
+ * Declarative game descriptions. A descriptor names, as types, where the
+ * score, the lives and the end of game are found in RAM; DescribedRomSettings
+ * turns it into a RomSettings whose step() is a handful of reads of the RIOT
+ * RAM, all resolved at compile time.
+ *
+ * A descriptor is a struct providing:
+ *
+ *   typedef ... Score;          // value read as the score
+ *   typedef ... ScoreInvalid;   // condition under which the score reads as 0
+ *   typedef ... Lives;          // value read as the remaining lives
+ *   typedef ... GameOver;       // condition read as the end of the game
+ *   static const int starting_lives;
+ *
+ * where values and conditions are built from the templates below, e.g.
+ *
+ *   typedef BcdScore<0x85, 0x83, 0x81> Score;
+ *   typedef AllOf<RamEquals<0xF2, 0>, RamEquals<0xF1, 0xBD> > GameOver;
+ *
+ * Addresses are given as in readRam(), i.e. between 0x80 and 0xFF.
+ * *****************************************************************************
+ */
+#ifndef __ROMDESCRIPTOR_HPP__
+#define __ROMDESCRIPTOR_HPP__
+
+#include "RomSettings.hpp"
+#include "RomUtils.hpp"
+#include "../emucore/m6502/src/bspf/src/bspf.hxx"
+
+// the byte at the given address
+template <int Address>
+struct RamByte {
+    static int read(const uInt8* ram) { return ram[Address & 0x7F]; }
+};
+
+// a value plus a constant
+template <class Value, int Offset>
+struct Add {
+    static int read(const uInt8* ram) { return Value::read(ram) + Offset; }
+};
+
+// a decimal value stored two digits per byte, least significant byte first;
+// BcdScore<lo, mid, hi> reads the same value as getDecimalScore(lo, mid, hi)
+template <int... Addresses>
+struct BcdScore;
+
+template <>
+struct BcdScore<> {
+    static int read(const uInt8*) { return 0; }
+};
+
+template <int Address, int... Higher>
+struct BcdScore<Address, Higher...> {
+    static int read(const uInt8* ram) {
+        int digits = ram[Address & 0x7F];
+        return 10 * (digits >> 4) + (digits & 15) + 100 * BcdScore<Higher...>::read(ram);
+    }
+};
+
+// whether the byte at the given address holds the given value
+template <int Address, int Value>
+struct RamEquals {
+    static bool read(const uInt8* ram) { return ram[Address & 0x7F] == Value; }
+};
+
+// whether all the conditions hold
+template <class... Conditions>
+struct AllOf;
+
+template <>
+struct AllOf<> {
+    static bool read(const uInt8*) { return true; }
+};
+
+template <class Condition, class... Others>
+struct AllOf<Condition, Others...> {
+    static bool read(const uInt8* ram) {
+        return Condition::read(ram) && AllOf<Others...>::read(ram);
+    }
+};
+
+// a condition which never holds
+struct Never {
+    static bool read(const uInt8*) { return false; }
+};
+
+
+/* RL wrapper for the games described by a descriptor; subclasses provide the
+   rest of the RomSettings interface (rom name, minimal actions, modes...) */
+template <class Descriptor>
+class DescribedRomSettings : public RomSettings {
+
+    public:
+
+        DescribedRomSettings() { reset(); }
+
+        // reset
+        void reset() {
+            m_reward   = 0;
+            m_score    = 0;
+            m_terminal = false;
+            m_lives    = Descriptor::starting_lives;
+            m_skip_game_over = false;
+        }
+
+        // is end of game
+        bool isTerminal() const { return m_terminal; }
+
+        // get the most recently observed reward
+        reward_t getReward() const { return m_reward; }
+
+        // process the latest information from ALE
+        void step(const System& system) {
+            const uInt8* ram = riotRam(&system);
+
+            // update the reward
+            int score = Descriptor::ScoreInvalid::read(ram) ? 0 : Descriptor::Score::read(ram);
+            m_reward = score - m_score;
+            m_score = score;
+
+            // update terminal status
+            m_terminal = !m_skip_game_over && Descriptor::GameOver::read(ram);
+            m_lives = Descriptor::Lives::read(ram);
+            m_skip_game_over = false;
+        }
+
+        // saves the state of the rom settings
+        void saveState(Serializer & ser) {
+            ser.putInt(m_reward);
+            ser.putInt(m_score);
+            ser.putBool(m_terminal);
+            ser.putInt(m_lives);
+        }
+
+        // loads the state of the rom settings
+        void loadState(Deserializer & ser) {
+            m_reward = ser.getInt();
+            m_score = ser.getInt();
+            m_terminal = ser.getBool();
+            m_lives = ser.getInt();
+        }
+
+        virtual int lives() { return isTerminal() ? 0 : m_lives; }
+
+    protected:
+
+        // set to ignore the end of game on the next step, e.g. when changing
+        // modes makes the RAM look like a game over
+        bool m_skip_game_over;
+
+    private:
+
+        bool m_terminal;
+        reward_t m_reward;
+        reward_t m_score;
+        int m_lives;
+};
+
+#endif // __ROMDESCRIPTOR_HPP__
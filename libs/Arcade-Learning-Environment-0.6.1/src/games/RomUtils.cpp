@@ -18,6 +18,8 @@
 
 #include "System.hxx"
 
+#include <cassert>
+
 
 /* reads a byte at a memory location between 0 and 128 */
 int readRam(const System* system, int offset) {
@@ -29,6 +31,16 @@ int readRam(const System* system, int offset) {
     return sys->peek((offset & 0x7F) + 0x80);
 }
 
+/* the RAM as mapped at 0x80; unlike peek, reading it leaves the data-bus alone */
+const unsigned char* riotRam(const System* system) {
+
+    System* sys = const_cast<System*>(system);
+    const System::PageAccess& access = sys->getPageAccess(0x80 >> sys->pageShift());
+    assert(access.directPeekBase != 0);
+
+    return access.directPeekBase;
+}
+
 /* extracts a decimal value from a byte */
 int getDecimalScore(int index, const System* system) {
     
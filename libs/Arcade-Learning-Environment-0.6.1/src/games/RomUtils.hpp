@@ -22,6 +22,9 @@ class System;
 // reads a byte at a memory location between 0 and 1023
 extern int readRam(const System* system, int offset);
 
+// the 128 bytes of RAM read by readRam(), without going through the bus
+extern const unsigned char* riotRam(const System* system);
+
 // extracts a decimal value from 1, 2, and 3 bytes respectively
 extern int getDecimalScore(int idx, const System* system);
 extern int getDecimalScore(int lo, int hi, const System* system);
@@ -29,12 +29,6 @@
 #include "../RomUtils.hpp"
 
 
-DemonAttackSettings::DemonAttackSettings() {
-
-    reset();
-}
-
-
 /* create a new instance of the rom */
 RomSettings* DemonAttackSettings::clone() const { 
     
@@ -44,42 +38,6 @@ RomSettings* DemonAttackSettings::clone() const {
 }
 
 
-/* process the latest information from ALE */
-void DemonAttackSettings::step(const System& system) {
-
-    // update the reward
-    int score = getDecimalScore(0x85, 0x83, 0x81, &system);
-    // MGB: something funny with the RAM; it is not initialized to 0?
-    if (readRam(&system, 0x81) == 0xAB && 
-        readRam(&system, 0x83) == 0xCD &&
-        readRam(&system, 0x85) == 0xEA) score = 0;
-    m_reward = score - m_score;
-    m_score = score;
-
-    // update terminal status
-    int lives_displayed = readRam(&system, 0xF2);
-    int display_flag = readRam(&system, 0xF1);
-    // for terminal checking, we must make sure that we do not detect incorrectly a level change as a game-over
-    m_terminal = (lives_displayed == 0) && display_flag == 0xBD && !m_level_change;
-    m_lives = lives_displayed + 1; // Once we reach terminal, lives() will correctly return 0
-    m_level_change = false;
-}
-
-
-/* is end of game */
-bool DemonAttackSettings::isTerminal() const {
-
-    return m_terminal;
-};
-
-
-/* get the most recently observed reward */
-reward_t DemonAttackSettings::getReward() const { 
-
-    return m_reward; 
-}
-
-
 /* is an action part of the minimal set? */
 bool DemonAttackSettings::isMinimal(const Action &a) const {
 
@@ -97,33 +55,6 @@ bool DemonAttackSettings::isMinimal(const Action &a) const {
 }
 
 
-/* reset the state of the game */
-void DemonAttackSettings::reset() {
-    
-    m_reward   = 0;
-    m_score    = 0;
-    m_terminal = false;
-    m_lives    = 4;
-    m_level_change = false;
-}
-
-        
-/* saves the state of the rom settings */
-void DemonAttackSettings::saveState(Serializer & ser) {
-  ser.putInt(m_reward);
-  ser.putInt(m_score);
-  ser.putBool(m_terminal);
-  ser.putInt(m_lives);
-}
-
-// loads the state of the rom settings
-void DemonAttackSettings::loadState(Deserializer & ser) {
-  m_reward = ser.getInt();
-  m_score = ser.getInt();
-  m_terminal = ser.getBool();
-  m_lives = ser.getInt();
-}
-
 // returns a list of mode that the game can be played in
 ModeVect DemonAttackSettings::getAvailableModes() {
     ModeVect modes = {1, 3, 5, 7};
@@ -146,7 +77,8 @@ void DemonAttackSettings::setMode(game_mode_t m, System &system,
             environment->pressSelect(1);
             mode = readRam(&system, 0xEA);
         }
-        m_level_change = true;
+        // the mode change must not be mistaken for a game over
+        m_skip_game_over = true;
         //reset the environment to apply changes.
         environment->softReset();
     }
@@ -27,25 +27,26 @@
 #ifndef __DEMONATTACK_HPP__
 #define __DEMONATTACK_HPP__
 
-#include "../RomSettings.hpp"
+#include "../RomDescriptor.hpp"
+
+
+/* where Demon Attack keeps its score, lives and game over flag */
+struct DemonAttackDescriptor {
+    typedef BcdScore<0x85, 0x83, 0x81> Score;
+    // MGB: something funny with the RAM; it is not initialized to 0?
+    typedef AllOf<RamEquals<0x81, 0xAB>, RamEquals<0x83, 0xCD>, RamEquals<0x85, 0xEA> > ScoreInvalid;
+    // Once we reach terminal, lives() will correctly return 0
+    typedef Add<RamByte<0xF2>, 1> Lives;
+    typedef AllOf<RamEquals<0xF2, 0>, RamEquals<0xF1, 0xBD> > GameOver;
+    static const int starting_lives = 4;
+};
 
 
 /* RL wrapper for Demon Attack settings */
-class DemonAttackSettings : public RomSettings {
+class DemonAttackSettings : public DescribedRomSettings<DemonAttackDescriptor> {
 
     public:
 
-        DemonAttackSettings();
-
-        // reset
-        void reset();
-
-        // is end of game
-        bool isTerminal() const;
-
-        // get the most recently observed reward
-        reward_t getReward() const;
-
         // the rom-name
         const char* rom() const { return "demon_attack"; }
 
@@ -58,17 +59,6 @@ class DemonAttackSettings : public RomSettings {
         // is an action part of the minimal set?
         bool isMinimal(const Action& a) const;
 
-        // process the latest information from ALE
-        void step(const System& system);
-
-        // saves the state of the rom settings
-        void saveState(Serializer & ser);
-    
-        // loads the state of the rom settings
-        void loadState(Deserializer & ser);
-
-        virtual int lives() { return isTerminal() ? 0 : m_lives; }
-
         // returns a list of mode that the game can be played in
         // in this game, there are 8 available modes
         ModeVect getAvailableModes();
@@ -81,14 +71,6 @@ class DemonAttackSettings : public RomSettings {
         // returns a list of difficulties that the game can be played in
         // in this game, there are 2 available difficulties
         DifficultyVect getAvailableDifficulties();
-
-    private:
-
-        bool m_terminal;
-        reward_t m_reward;
-        reward_t m_score;
-        int m_lives;
-        bool m_level_change;
 };
 
 #endif // __DEMONATTACK_HPP__
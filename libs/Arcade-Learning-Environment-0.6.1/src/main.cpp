@@ -33,6 +33,7 @@
 #include "controllers/ale_controller.hpp"
 #include "controllers/fifo_controller.hpp"
 #include "controllers/rlglue_controller.hpp"
+#include "controllers/shm_controller.hpp"
 #include "common/Constants.h"
 #include "ale_interface.hpp"
 
@@ -53,6 +54,10 @@ static ALEController* createController(OSystem* osystem, std::string type) {
     std::cerr << "Game will be controlled through named FIFO pipes." << std::endl;
     return new FIFOController(osystem, true);
   }
+  else if (type == "shm") {
+    std::cerr << "Game will be controlled through shared memory." << std::endl;
+    return new ShmController(osystem);
+  }
   else if (type == "rlglue") {
     std::cerr << "Game will be controlled through RL-Glue." << std::endl;
     return new RLGlueController(osystem); 
@@ -2,7 +2,9 @@ MODULE := src/
 
 MODULE_OBJS := \
 	src/main.o \
-	src/ale_interface.o
+	src/ale_interface.o \
+	src/vector_ale.o \
+	src/trajectory.o
 
 MODULE_DIRS += \
 	src/
@@ -0,0 +1,182 @@
+/* *****************************************************************************
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ * *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  trajectory.cpp
+ *
+ *  Recording of action trajectories, and their deterministic replay.
+ **************************************************************************** */
+
+#include "trajectory.hpp"
+#include "ale_interface.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+// File layout: magic, seed, mode, difficulty and number of steps (little-endian
+// 32-bit values), then runs of equal steps as (step code, varint run length)
+static const char TRAJECTORY_MAGIC[8] = { 'A', 'L', 'E', 'T', 'R', 'A', 'J', '1' };
+
+static void putU32(std::vector<unsigned char>& out, uInt32 v) {
+  for (int i = 0; i < 4; i++) out.push_back((v >> (8 * i)) & 0xFF);
+}
+
+static uInt32 getU32(const unsigned char* p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uInt32)p[3] << 24);
+}
+
+Trajectory::Trajectory() :
+  seed(0),
+  mode(0),
+  difficulty(0) {
+}
+
+bool Trajectory::save(const std::string& filename) const {
+  std::vector<unsigned char> data(TRAJECTORY_MAGIC, TRAJECTORY_MAGIC + 8);
+  putU32(data, seed);
+  putU32(data, mode);
+  putU32(data, difficulty);
+  putU32(data, m_steps.size());
+
+  // Agents often repeat an action for many steps, so runs are stored once
+  size_t i = 0;
+  while (i < m_steps.size()) {
+    size_t run = 1;
+    while (i + run < m_steps.size() && m_steps[i + run] == m_steps[i]) run++;
+    data.push_back(m_steps[i]);
+    for (size_t v = run; ; v >>= 7) {
+      if (v < 0x80) {
+        data.push_back((unsigned char)v);
+        break;
+      }
+      data.push_back((unsigned char)(0x80 | (v & 0x7F)));
+    }
+    i += run;
+  }
+
+  std::ofstream out(filename.c_str(), std::ios_base::binary);
+  out.write((const char*)&data[0], data.size());
+  return out.good();
+}
+
+bool Trajectory::load(const std::string& filename) {
+  std::ifstream in(filename.c_str(), std::ios_base::binary);
+  if (!in.good()) return false;
+  std::vector<unsigned char> data((std::istreambuf_iterator<char>(in)),
+                                  std::istreambuf_iterator<char>());
+
+  const size_t header_size = 8 + 4 * 4;
+  if (data.size() < header_size || memcmp(&data[0], TRAJECTORY_MAGIC, 8) != 0) return false;
+  uInt32 num_steps = getU32(&data[20]);
+
+  std::vector<unsigned char> steps;
+  steps.reserve(num_steps);
+  size_t p = header_size;
+  while (p < data.size()) {
+    unsigned char code = data[p++];
+    size_t run = 0;
+    for (int shift = 0; ; shift += 7) {
+      if (p >= data.size() || shift > 28) return false;
+      unsigned char byte = data[p++];
+      run |= (size_t)(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) break;
+    }
+    if (steps.size() + run > num_steps) return false;
+    steps.insert(steps.end(), run, code);
+  }
+  if (steps.size() != num_steps) return false;
+
+  seed = getU32(&data[8]);
+  mode = getU32(&data[12]);
+  difficulty = getU32(&data[16]);
+  m_steps.swap(steps);
+  return true;
+}
+
+TrajectoryPlayer::TrajectoryPlayer(ALEInterface& ale, Trajectory trajectory,
+                                   size_t checkpoint_interval) :
+  m_ale(ale),
+  m_trajectory(std::move(trajectory)),
+  m_checkpoint_interval(checkpoint_interval > 0 ? checkpoint_interval : 1),
+  m_position(0) {
+
+  // Same start as ALEInterface::startRecording(). The mode and difficulty come
+  // from the recorded state, where mode 0 stands for the game's default mode.
+  m_ale.environment->setMode(m_trajectory.mode);
+  m_ale.environment->setDifficulty(m_trajectory.difficulty);
+  m_ale.theOSystem->rng().seed(m_trajectory.seed);
+  m_ale.environment->reset();
+
+  saveCheckpoint(0);
+}
+
+void TrajectoryPlayer::saveCheckpoint(size_t index) {
+  if (index >= m_checkpoints.size()) m_checkpoints.resize(index + 1);
+  Checkpoint& checkpoint = m_checkpoints[index];
+  m_ale.cloneSystemState(checkpoint.state);
+  m_ale.environment->getStickyActions(checkpoint.player_a_action, checkpoint.player_b_action);
+}
+
+void TrajectoryPlayer::seek(size_t target) {
+  if (target > m_trajectory.size()) {
+    throw std::runtime_error("Seeking past the end of the trajectory");
+  }
+
+  // Restore the last checkpoint before the target, unless the replay is already
+  // between that checkpoint and the target. At least one step is replayed after
+  // a restore (except for step 0), since restoring a state does not redraw the screen.
+  size_t index = target == 0 ? 0 : (target - 1) / m_checkpoint_interval;
+  index = std::min(index, m_checkpoints.size() - 1);
+  size_t checkpoint_step = index * m_checkpoint_interval;
+  if (m_position < checkpoint_step || m_position > target) {
+    const Checkpoint& checkpoint = m_checkpoints[index];
+    m_ale.restoreSystemState(checkpoint.state);
+    m_ale.environment->setStickyActions(checkpoint.player_a_action, checkpoint.player_b_action);
+    m_position = checkpoint_step;
+  }
+
+  while (m_position < target) step();
+}
+
+reward_t TrajectoryPlayer::step() {
+  if (done()) {
+    throw std::runtime_error("The trajectory has no more steps");
+  }
+
+  reward_t reward = 0;
+  if (m_trajectory.isReset(m_position)) {
+    m_ale.reset_game();
+  } else {
+    reward = m_ale.act(m_trajectory.action(m_position));
+  }
+  m_position++;
+
+  // Checkpoints are taken the first time the replay goes past them
+  if (m_position % m_checkpoint_interval == 0 &&
+      m_position / m_checkpoint_interval == m_checkpoints.size()) {
+    saveCheckpoint(m_checkpoints.size());
+  }
+  return reward;
+}
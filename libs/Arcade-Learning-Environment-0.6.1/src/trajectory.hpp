@@ -0,0 +1,130 @@
+/* *****************************************************************************
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ * *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  trajectory.hpp
+ *
+ *  Recording of action trajectories, and their deterministic replay.
+ **************************************************************************** */
+#ifndef __TRAJECTORY_HPP__
+#define __TRAJECTORY_HPP__
+
+#include "environment/ale_state.hpp"
+#include "common/Constants.h"
+
+#include <string>
+#include <vector>
+
+class ALEInterface;
+
+/**
+   Everything needed to replay a recorded run: the seed of the random number
+   generator, the game mode and difficulty, and the sequence of steps, one
+   byte each. A step is either a call to act() or a call to reset_game().
+
+   Replaying also requires the same ROM and the same settings affecting
+   emulation (frame_skip, repeat_action_probability, max_num_noop_starts...)
+   as when the trajectory was recorded.
+ */
+class Trajectory {
+public:
+  // Step code of a call to reset_game()
+  static const unsigned char RESET_STEP = 0xFF;
+
+  Trajectory();
+
+  uInt32 seed;
+  game_mode_t mode;
+  difficulty_t difficulty;
+
+  // Appends a call to act(action) or to reset_game().
+  void addAction(Action action) { m_steps.push_back((unsigned char)action); }
+  void addReset() { m_steps.push_back(RESET_STEP); }
+
+  // Number of steps.
+  size_t size() const { return m_steps.size(); }
+
+  // Whether step i is a reset, and its action otherwise.
+  bool isReset(size_t i) const { return m_steps[i] == RESET_STEP; }
+  Action action(size_t i) const { return (Action)m_steps[i]; }
+
+  // Saves the trajectory to a file, with the steps run-length encoded; returns false if
+  // the file cannot be written.
+  bool save(const std::string& filename) const;
+
+  // Loads a trajectory saved with save(); returns false if the file cannot be read.
+  bool load(const std::string& filename);
+
+private:
+  std::vector<unsigned char> m_steps;
+};
+
+/**
+   Replays a trajectory on an environment, headlessly and as fast as the
+   emulator runs. Every checkpoint_interval steps the system state (random
+   number generator included) is cloned as the replay goes past it, so that
+   once the replay has reached a step, seeking anywhere before it costs at
+   most checkpoint_interval steps of emulation.
+ */
+class TrajectoryPlayer {
+public:
+  // The environment must have loaded the ROM the trajectory was recorded on,
+  // with the same settings. Sets the mode and difficulty and starts the replay
+  // at step 0. The player keeps its own copy of the trajectory.
+  TrajectoryPlayer(ALEInterface& ale, Trajectory trajectory,
+                   size_t checkpoint_interval = 1000);
+
+  // Brings the environment to the state it had after the first 'step' steps of
+  // the trajectory. Steps are replayed from the last checkpoint before 'step',
+  // or from the current position when that is closer.
+  void seek(size_t step);
+
+  // Replays the next step and returns its reward (0 for a reset).
+  reward_t step();
+
+  const Trajectory& trajectory() const { return m_trajectory; }
+
+  // Number of steps replayed so far.
+  size_t position() const { return m_position; }
+
+  // Whether every step of the trajectory has been replayed.
+  bool done() const { return m_position >= m_trajectory.size(); }
+
+private:
+  struct Checkpoint {
+    ALEState state;
+    Action player_a_action;
+    Action player_b_action;
+  };
+
+  void saveCheckpoint(size_t index);
+
+  ALEInterface& m_ale;
+  const Trajectory m_trajectory;
+  size_t m_checkpoint_interval;
+  size_t m_position;
+
+  // m_checkpoints[i] holds the state after i * m_checkpoint_interval steps
+  std::vector<Checkpoint> m_checkpoints;
+};
+
+#endif // __TRAJECTORY_HPP__
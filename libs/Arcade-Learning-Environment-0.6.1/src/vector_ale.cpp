@@ -0,0 +1,258 @@
+/* *****************************************************************************
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ * *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  vector_ale.cpp
+ *
+ *  Batched interface stepping several environments on a pool of threads.
+ **************************************************************************** */
+
+#include "vector_ale.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+
+VectorALE::VectorALE(int num_envs, int num_threads) :
+  m_num_envs(num_envs),
+  m_base_seed(0),
+  m_observe_screen(true),
+  m_observe_ram(true),
+  m_screen_size(0),
+  m_task(NULL),
+  m_next_index(0),
+  m_generation(0),
+  m_busy_workers(0),
+  m_shutdown(false) {
+
+  if (num_envs <= 0) {
+    throw std::runtime_error("VectorALE needs at least one environment");
+  }
+
+  for (int i = 0; i < num_envs; i++) {
+    m_envs.push_back(std::unique_ptr<ALEInterface>(new ALEInterface()));
+  }
+
+  m_rewards.resize(num_envs, 0);
+  m_terminals.resize(num_envs, 0);
+  m_rams.resize(num_envs * RAM_SIZE, 0);
+
+  if (num_threads <= 0) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  // The calling thread takes part in the work, and there is no point in
+  // having more threads than environments.
+  int num_workers = std::min(num_threads, num_envs) - 1;
+  for (int i = 0; i < num_workers; i++) {
+    m_workers.push_back(std::thread(&VectorALE::workerLoop, this));
+  }
+}
+
+VectorALE::~VectorALE() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_shutdown = true;
+  }
+  m_work_cv.notify_all();
+  for (size_t i = 0; i < m_workers.size(); i++) {
+    m_workers[i].join();
+  }
+}
+
+void VectorALE::applySetting(const std::function<void(ALEInterface&)>& setter) {
+  for (int i = 0; i < m_num_envs; i++) {
+    setter(*m_envs[i]);
+  }
+}
+
+void VectorALE::setString(const std::string& key, const std::string& value) {
+  applySetting([&](ALEInterface& ale) { ale.setString(key, value); });
+}
+
+void VectorALE::setInt(const std::string& key, const int value) {
+  if (key == "random_seed") {
+    // Seeds are assigned per environment when the ROM is loaded
+    m_base_seed = value;
+    return;
+  }
+  applySetting([&](ALEInterface& ale) { ale.setInt(key, value); });
+}
+
+void VectorALE::setBool(const std::string& key, const bool value) {
+  applySetting([&](ALEInterface& ale) { ale.setBool(key, value); });
+}
+
+void VectorALE::setFloat(const std::string& key, const float value) {
+  applySetting([&](ALEInterface& ale) { ale.setFloat(key, value); });
+}
+
+void VectorALE::loadROM(const std::string& rom_file) {
+  // A zero seed means 'time' in ALE; pick the time once so that the
+  // environments still end up with distinct seeds.
+  int base_seed = m_base_seed;
+  if (base_seed == 0) {
+    base_seed = (int)(time(NULL) & 0x3FFFFFFF);
+  }
+
+  std::function<void(int)> task = [this, &rom_file, base_seed](int i) {
+    m_envs[i]->setInt("random_seed", base_seed + i);
+    m_envs[i]->loadROM(rom_file);
+  };
+  parallelFor(task);
+
+  const ALEScreen& screen = m_envs[0]->getScreen();
+  m_screen_size = screen.width() * screen.height();
+  m_screens.assign(m_num_envs * m_screen_size, 0);
+
+  for (int i = 0; i < m_num_envs; i++) {
+    copyObservations(i);
+  }
+}
+
+void VectorALE::setObservations(bool screen, bool ram) {
+  m_observe_screen = screen;
+  m_observe_ram = ram;
+}
+
+ALEInterface& VectorALE::getEnvironment(int index) {
+  assert(index >= 0 && index < m_num_envs);
+  return *m_envs[index];
+}
+
+ActionVect VectorALE::getMinimalActionSet() {
+  return m_envs[0]->getMinimalActionSet();
+}
+
+void VectorALE::copyObservations(int index) {
+  ALEInterface& ale = *m_envs[index];
+  if (m_observe_screen) {
+    const ALEScreen& screen = ale.getScreen();
+    memcpy(&m_screens[index * m_screen_size], screen.getArray(), m_screen_size);
+  }
+  if (m_observe_ram) {
+    const ALERAM& ram = ale.getRAM();
+    memcpy(&m_rams[index * RAM_SIZE], ram.array(), RAM_SIZE);
+  }
+}
+
+void VectorALE::reset() {
+  std::function<void(int)> task = [this](int i) {
+    m_envs[i]->reset_game();
+    m_rewards[i] = 0;
+    m_terminals[i] = 0;
+    copyObservations(i);
+  };
+  parallelFor(task);
+}
+
+void VectorALE::act(const ActionVect& actions) {
+  if ((int)actions.size() != m_num_envs) {
+    throw std::runtime_error("VectorALE::act expects one action per environment");
+  }
+  act(&actions[0]);
+}
+
+void VectorALE::act(const Action* actions) {
+  std::function<void(int)> task = [this, actions](int i) {
+    ALEInterface& ale = *m_envs[i];
+    m_rewards[i] = ale.act(actions[i]);
+    m_terminals[i] = ale.game_over() ? 1 : 0;
+    if (m_terminals[i]) {
+      ale.reset_game();
+    }
+    copyObservations(i);
+  };
+  parallelFor(task);
+}
+
+void VectorALE::getScreensGrayscale(unsigned char* output) {
+  std::function<void(int)> task = [this, output](int i) {
+    const ColourPalette& palette = m_envs[i]->theOSystem->colourPalette();
+    palette.applyPaletteGrayscale(output + i * m_screen_size,
+        &m_screens[i * m_screen_size], m_screen_size);
+  };
+  parallelFor(task);
+}
+
+void VectorALE::getScreensRGB(unsigned char* output, ColourPalette::Layout layout) {
+  std::function<void(int)> task = [this, output, layout](int i) {
+    const ColourPalette& palette = m_envs[i]->theOSystem->colourPalette();
+    palette.applyPaletteRGB(output + 3 * i * m_screen_size,
+        &m_screens[i * m_screen_size], m_screen_size, layout);
+  };
+  parallelFor(task);
+}
+
+void VectorALE::parallelFor(const std::function<void(int)>& task) {
+  if (m_workers.empty()) {
+    for (int i = 0; i < m_num_envs; i++) {
+      task(i);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_task = &task;
+    m_next_index = 0;
+    m_busy_workers = (int)m_workers.size();
+    m_generation++;
+  }
+  m_work_cv.notify_all();
+
+  runTasks();
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_done_cv.wait(lock, [this] { return m_busy_workers == 0; });
+  m_task = NULL;
+}
+
+void VectorALE::runTasks() {
+  int i;
+  while ((i = m_next_index.fetch_add(1)) < m_num_envs) {
+    (*m_task)(i);
+  }
+}
+
+void VectorALE::workerLoop() {
+  unsigned long seen_generation = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_work_cv.wait(lock, [&] {
+        return m_shutdown || m_generation != seen_generation;
+      });
+      if (m_shutdown) return;
+      seen_generation = m_generation;
+    }
+
+    runTasks();
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_busy_workers--;
+    }
+    m_done_cv.notify_one();
+  }
+}
@@ -0,0 +1,143 @@
+/* *****************************************************************************
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ * *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  vector_ale.hpp
+ *
+ *  Batched interface stepping several environments on a pool of threads.
+ **************************************************************************** */
+#ifndef __VECTOR_ALE_HPP__
+#define __VECTOR_ALE_HPP__
+
+#include "ale_interface.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+   Owns N independent environments (each with its own OSystem, Settings,
+   RomSettings and StellaEnvironment) and steps them together. Results of a
+   step are stored in contiguous arrays indexed by environment: rewards and
+   terminal flags hold one entry per environment, screens hold width*height
+   pixels per environment and RAM holds RAM_SIZE bytes per environment.
+
+   Environments whose episode ended during a step are reset immediately; the
+   terminal flag of that step is still reported, but the observation is the
+   first one of the new episode.
+ */
+class VectorALE {
+public:
+  // Creates num_envs environments. The environments are stepped by
+  // num_threads threads, the calling thread included; 0 picks one thread
+  // per hardware core.
+  VectorALE(int num_envs, int num_threads = 0);
+  ~VectorALE();
+
+  // Set the value of a setting on every environment. The random seed is
+  // offset by the environment index so that no two environments share it.
+  // loadROM() must be called before the setting will take effect.
+  void setString(const std::string& key, const std::string& value);
+  void setInt(const std::string& key, const int value);
+  void setBool(const std::string& key, const bool value);
+  void setFloat(const std::string& key, const float value);
+
+  // Loads the game in every environment and resets them.
+  void loadROM(const std::string& rom_file);
+
+  // Selects which observations act() and reset() copy into the batch
+  // buffers. Both are copied by default.
+  void setObservations(bool screen, bool ram);
+
+  // Resets the game in every environment.
+  void reset();
+
+  // Applies actions[i] to environment i, for every environment, and fills
+  // the reward, terminal and observation buffers.
+  void act(const Action* actions);
+  void act(const ActionVect& actions);
+
+  // Number of environments.
+  int size() const { return m_num_envs; }
+
+  // Direct access to the environment at the given index.
+  ALEInterface& getEnvironment(int index);
+
+  // Returns the vector of the minimal set of actions needed to play the game.
+  ActionVect getMinimalActionSet();
+
+  // Batch buffers filled by the last call to act() or reset().
+  const reward_t* getRewards() const { return m_rewards.data(); }
+  const unsigned char* getTerminals() const { return m_terminals.data(); }
+  const pixel_t* getScreens() const { return m_screens.data(); }
+  const byte_t* getRAMs() const { return m_rams.data(); }
+
+  // Size in pixels of one screen inside the buffer returned by getScreens().
+  size_t screenSize() const { return m_screen_size; }
+
+  // Converts the screens of the last call to act() or reset() through the palette.
+  // The output holds screenSize() bytes (grayscale) or 3 * screenSize() bytes (RGB,
+  // in the given layout) per environment, one environment after the other.
+  void getScreensGrayscale(unsigned char* output);
+  void getScreensRGB(unsigned char* output,
+                     ColourPalette::Layout layout = ColourPalette::LAYOUT_HWC);
+
+private:
+  void applySetting(const std::function<void(ALEInterface&)>& setter);
+  void copyObservations(int index);
+
+  // Runs task(i) for every environment index i, spread over the pool.
+  void parallelFor(const std::function<void(int)>& task);
+  void runTasks();
+  void workerLoop();
+
+  int m_num_envs;
+  int m_base_seed;
+  bool m_observe_screen;
+  bool m_observe_ram;
+  size_t m_screen_size;
+
+  std::vector<std::unique_ptr<ALEInterface> > m_envs;
+
+  std::vector<reward_t> m_rewards;
+  std::vector<unsigned char> m_terminals;
+  std::vector<pixel_t> m_screens;
+  std::vector<byte_t> m_rams;
+
+  // Thread pool state
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_work_cv;
+  std::condition_variable m_done_cv;
+  const std::function<void(int)>* m_task;
+  std::atomic<int> m_next_index;
+  unsigned long m_generation;
+  int m_busy_workers;
+  bool m_shutdown;
+};
+
+#endif // __VECTOR_ALE_HPP__
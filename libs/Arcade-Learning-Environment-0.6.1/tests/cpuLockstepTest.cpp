@@ -0,0 +1,177 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  cpuLockstepTest.cpp
+ *
+ *  Runs the 'low' and 'fast' CPU cores side by side, as cpuLockstepExample
+ *  does, and checks that they are in the same state after every action. This
+ *  is done on the given ROM, and on a bank-switched cartridge built by the
+ *  test: an 8K F8 cartridge with SuperChip RAM, which switches banks every
+ *  frame and runs code it writes into the cartridge RAM. M6502Fast must then
+ *  drop the decoded code of switched pages and never decode the RAM pages.
+ *
+ *  Usage: cpuLockstepTest rom_file
+ **************************************************************************** */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <ale_interface.hpp>
+
+// Where the bank-switched cartridge keeps the bank it runs from
+static const int BANK_ID_ADDRESS = 0x82;
+
+// Builds one 4K bank of the cartridge; both banks run the same code, except
+// for the number they store at BANK_ID_ADDRESS
+static void buildBank(uInt8* bank, uInt8 bank_id) {
+  // The first 256 bytes are the SuperChip RAM ports, and must all be the same
+  // for the cartridge to be detected as F8SC
+  memset(bank, 0, 4096);
+  const uInt8 code[] = {
+    0x78,                   // F100       SEI
+    0xD8,                   // F101       CLD
+    0xA2, 0xFF,             // F102       LDX #$FF
+    0x9A,                   // F104       TXS
+    0xA9, 0x00,             // F105       LDA #0
+    0x95, 0x00,             // F107 clr:  STA $00,X
+    0xCA,                   // F109       DEX
+    0xD0, 0xFB,             // F10A       BNE clr
+    0xA9, 0x02,             // F10C frame:LDA #2
+    0x85, 0x00,             // F10E       STA VSYNC
+    0x85, 0x02,             // F110       STA WSYNC
+    0x85, 0x02,             // F112       STA WSYNC
+    0x85, 0x02,             // F114       STA WSYNC
+    0xA9, 0x00,             // F116       LDA #0
+    0x85, 0x00,             // F118       STA VSYNC
+    // Write "LDA #counter / STA $83 / INC $80 / RTS" into the RAM write port
+    0xA9, 0xA9,             // F11A       LDA #$A9
+    0x8D, 0x00, 0xF0,       // F11C       STA $F000
+    0xA5, 0x81,             // F11F       LDA $81
+    0x8D, 0x01, 0xF0,       // F121       STA $F001
+    0xA9, 0x85,             // F124       LDA #$85
+    0x8D, 0x02, 0xF0,       // F126       STA $F002
+    0xA9, 0x83,             // F129       LDA #$83
+    0x8D, 0x03, 0xF0,       // F12B       STA $F003
+    0xA9, 0xE6,             // F12E       LDA #$E6
+    0x8D, 0x04, 0xF0,       // F130       STA $F004
+    0xA9, 0x80,             // F133       LDA #$80
+    0x8D, 0x05, 0xF0,       // F135       STA $F005
+    0xA9, 0x60,             // F138       LDA #$60
+    0x8D, 0x06, 0xF0,       // F13A       STA $F006
+    0x20, 0x80, 0xF0,       // F13D       JSR $F080 (the RAM read port)
+    0xE6, 0x81,             // F140       INC $81
+    // Switch to bank 1 on odd frames and to bank 0 on even ones
+    0xA5, 0x81,             // F142       LDA $81
+    0x29, 0x01,             // F144       AND #1
+    0xF0, 0x06,             // F146       BEQ even
+    0xAD, 0xF9, 0xFF,       // F148       LDA $FFF9
+    0x4C, 0x51, 0xF1,       // F14B       JMP kernel
+    0xAD, 0xF8, 0xFF,       // F14E even: LDA $FFF8
+    0xA2, bank_id,          // F151 kernel:LDX #bank_id
+    0x86, BANK_ID_ADDRESS,  // F153       STX $82
+    0xA0, 0xDC,             // F155       LDY #220
+    0x85, 0x02,             // F157 line: STA WSYNC
+    0x84, 0x09,             // F159       STY COLUBK
+    0x88,                   // F15B       DEY
+    0xD0, 0xF9,             // F15C       BNE line
+    0x4C, 0x0C, 0xF1        // F15E       JMP frame
+  };
+  memcpy(bank + 0x100, code, sizeof(code));
+
+  // Reset and break vectors
+  bank[0xFFC] = bank[0xFFE] = 0x00;
+  bank[0xFFD] = bank[0xFFF] = 0xF1;
+}
+
+static void setUp(ALEInterface& ale, const char* cpu, const std::string& rom_file) {
+  ale.setInt("random_seed", 123);
+  ale.setString("cpu", cpu);
+  ale.loadROM(rom_file);
+}
+
+// Plays the same random actions on both cores. Returns false at the first
+// difference; 'bank_ids' gets the values seen at BANK_ID_ADDRESS.
+static bool lockstep(const std::string& rom_file, int steps, std::vector<bool>& bank_ids) {
+  ALEInterface ale_low, ale_fast;
+  setUp(ale_low, "low", rom_file);
+  setUp(ale_fast, "fast", rom_file);
+
+  ActionVect legal_actions = ale_low.getLegalActionSet();
+  srand(123);
+  bank_ids.assign(256, false);
+  for (int step = 0; step < steps; step++) {
+    Action a = legal_actions[rand() % legal_actions.size()];
+    reward_t reward_low = ale_low.act(a);
+    reward_t reward_fast = ale_fast.act(a);
+
+    // The serialized system state covers the CPU, RIOT, TIA and cartridge
+    if (reward_low != reward_fast || ale_low.game_over() != ale_fast.game_over() ||
+        memcmp(ale_low.getRAM().array(), ale_fast.getRAM().array(), RAM_SIZE) != 0 ||
+        memcmp(ale_low.getScreen().getArray(), ale_fast.getScreen().getArray(),
+               ale_low.getScreen().arraySize()) != 0 ||
+        ale_low.cloneSystemState().serialize() != ale_fast.cloneSystemState().serialize()) {
+      std::cerr << rom_file << ": cores diverge at step " << step << std::endl;
+      return false;
+    }
+    bank_ids[ale_low.getRAM().get(BANK_ID_ADDRESS)] = true;
+
+    if (ale_low.game_over()) {
+      ale_low.reset_game();
+      ale_fast.reset_game();
+    }
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " rom_file" << std::endl;
+    return 1;
+  }
+  ale::Logger::setMode(ale::Logger::Error);
+
+  std::vector<bool> bank_ids;
+  if (!lockstep(argv[1], 5000, bank_ids)) {
+    return 1;
+  }
+
+  // ALE picks the game settings from the file name; Pong's only read RAM the
+  // cartridge never writes, so the episode goes on for the whole test
+  char dir[] = "cpuLockstepTestXXXXXX";
+  if (mkdtemp(dir) == NULL) {
+    std::cerr << "Cannot create a directory for the test cartridge" << std::endl;
+    return 1;
+  }
+  std::string cart_file = std::string(dir) + "/pong.bin";
+  std::vector<uInt8> image(8192);
+  buildBank(&image[0], 1);
+  buildBank(&image[4096], 2);
+  std::ofstream(cart_file.c_str(), std::ios::binary)
+      .write(reinterpret_cast<const char*>(&image[0]), image.size());
+
+  bool agree = lockstep(cart_file, 2000, bank_ids);
+  remove(cart_file.c_str());
+  rmdir(dir);
+  if (!agree) {
+    return 1;
+  }
+  if (!bank_ids[1] || !bank_ids[2]) {
+    std::cerr << "The test cartridge did not run from both banks" << std::endl;
+    return 1;
+  }
+
+  std::cout << "cpuLockstepTest: OK" << std::endl;
+  return 0;
+}
@@ -0,0 +1,110 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  episodeFileTest.cpp
+ *
+ *  Records screens to an episode file with record_episode_file, reads them
+ *  back with EpisodeReader, and checks that every frame matches the screen
+ *  seen before the corresponding action, read in order and at random.
+ *
+ *  Usage: episodeFileTest rom_file
+ **************************************************************************** */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <unistd.h>
+#include <ale_interface.hpp>
+#include <common/EpisodeFile.hpp>
+
+// Spans several keyframes (one every 256 frames)
+static const int NUM_STEPS = 1000;
+
+// Frames decoded per call when reading in order
+static const int BATCH_SIZE = 64;
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " rom_file" << std::endl;
+    return 1;
+  }
+  ale::Logger::setMode(ale::Logger::Error);
+
+  char episode_file[] = "episodeFileTestXXXXXX";
+  int fd = mkstemp(episode_file);
+  if (fd < 0) {
+    std::cerr << "Cannot create the episode file" << std::endl;
+    return 1;
+  }
+  close(fd);
+
+  // Each act() records the screen as it was before the action
+  std::vector<std::vector<pixel_t> > screens;
+  {
+    ALEInterface ale;
+    ale.setInt("random_seed", 123);
+    ale.setString("record_episode_file", episode_file);
+    ale.loadROM(argv[1]);
+    ActionVect actions = ale.getMinimalActionSet();
+    srand(7);
+    for (int i = 0; i < NUM_STEPS; i++) {
+      const ALEScreen& screen = ale.getScreen();
+      screens.push_back(std::vector<pixel_t>(screen.getArray(),
+                                             screen.getArray() + screen.arraySize()));
+      ale.act(actions[rand() % actions.size()]);
+      if (ale.game_over()) ale.reset_game();
+    }
+    // Destroying the interface writes the frame index
+  }
+
+  EpisodeReader reader;
+  int failures = 0;
+  if (!reader.open(episode_file) || reader.numFrames() != (size_t)NUM_STEPS ||
+      reader.frameSize() != screens[0].size()) {
+    std::cerr << "Cannot read back " << NUM_STEPS << " frames from the episode file"
+              << std::endl;
+    remove(episode_file);
+    return 1;
+  }
+
+  std::vector<pixel_t> frames(BATCH_SIZE * reader.frameSize());
+  for (int first = 0; first < NUM_STEPS; first += BATCH_SIZE) {
+    int count = std::min(BATCH_SIZE, NUM_STEPS - first);
+    if (!reader.decodeFrames(first, count, &frames[0])) {
+      failures++;
+      continue;
+    }
+    for (int i = 0; i < count; i++) {
+      if (memcmp(&frames[i * reader.frameSize()], &screens[first + i][0],
+                 reader.frameSize()) != 0) {
+        failures++;
+      }
+    }
+  }
+  for (int k = 0; k < 100; k++) {
+    int frame = rand() % NUM_STEPS;
+    if (!reader.decodeFrame(frame, &frames[0]) ||
+        memcmp(&frames[0], &screens[frame][0], reader.frameSize()) != 0) {
+      failures++;
+    }
+  }
+  remove(episode_file);
+
+  if (failures > 0) {
+    std::cerr << failures << " frames read back differ from the recorded screens"
+              << std::endl;
+    return 1;
+  }
+  std::cout << "episodeFileTest: OK" << std::endl;
+  return 0;
+}
@@ -0,0 +1,93 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  renderLastTest.cpp
+ *
+ *  Plays the same actions with render_mode 'all' and 'last', and checks that
+ *  every step leaves the same screen, RAM, reward and frame number. Episodes
+ *  end inside an action, so render_mode 'last' has to emulate the frames it
+ *  did not draw again.
+ *
+ *  Usage: renderLastTest rom_file
+ **************************************************************************** */
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <ale_interface.hpp>
+
+static const int NUM_STEPS = 3000;
+
+static void configure(ALEInterface& ale, const char* render_mode, int frame_skip,
+                      bool color_averaging) {
+  ale.setInt("random_seed", 123);
+  ale.setString("render_mode", render_mode);
+  ale.setInt("frame_skip", frame_skip);
+  ale.setBool("color_averaging", color_averaging);
+  // Not a multiple of the frame skips, so that episodes end inside an action
+  ale.setInt("max_num_frames_per_episode", 301);
+}
+
+// Returns the number of steps which differ between the two render modes
+static int compare(const char* rom_file, int frame_skip, bool color_averaging,
+                   int& num_episodes) {
+  ALEInterface all, last;
+  configure(all, "all", frame_skip, color_averaging);
+  configure(last, "last", frame_skip, color_averaging);
+  all.loadROM(rom_file);
+  last.loadROM(rom_file);
+
+  ActionVect actions = all.getMinimalActionSet();
+  srand(7);
+  int failures = 0;
+  for (int i = 0; i < NUM_STEPS; i++) {
+    Action action = actions[rand() % actions.size()];
+    reward_t reward_all = all.act(action);
+    reward_t reward_last = last.act(action);
+
+    const ALEScreen& screen_all = all.getScreen();
+    const ALEScreen& screen_last = last.getScreen();
+    if (reward_all != reward_last || all.game_over() != last.game_over() ||
+        all.getFrameNumber() != last.getFrameNumber() ||
+        memcmp(all.getRAM().array(), last.getRAM().array(), RAM_SIZE) != 0 ||
+        memcmp(screen_all.getArray(), screen_last.getArray(), screen_all.arraySize()) != 0) {
+      failures++;
+    }
+
+    if (all.game_over()) {
+      num_episodes++;
+      all.reset_game();
+      last.reset_game();
+    }
+  }
+  return failures;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " rom_file" << std::endl;
+    return 1;
+  }
+  ale::Logger::setMode(ale::Logger::Error);
+
+  int num_episodes = 0;
+  int failures = compare(argv[1], 4, false, num_episodes) +
+                 compare(argv[1], 3, true, num_episodes);
+  if (num_episodes == 0) {
+    std::cerr << "No episode ended" << std::endl;
+    return 1;
+  }
+  if (failures > 0) {
+    std::cerr << failures << " steps differ between render modes" << std::endl;
+    return 1;
+  }
+  std::cout << "renderLastTest: OK" << std::endl;
+  return 0;
+}
@@ -0,0 +1,68 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  resetCacheTest.cpp
+ *
+ *  Checks that, with the default reset_cache_size, repeated resets are served
+ *  from the reset cache once each power-on state has been seen, and that a
+ *  restored reset leaves the same RAM as an emulated one.
+ *
+ *  Usage: resetCacheTest rom_file
+ **************************************************************************** */
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <ale_interface.hpp>
+
+static const int NUM_RESETS = 1000;
+
+// The power-on RIOT timer takes this many values (see M6532::reset)
+static const int NUM_POWER_ON_STATES = 75;
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " rom_file" << std::endl;
+    return 1;
+  }
+  ale::Logger::setMode(ale::Logger::Error);
+
+  ALEInterface cached, emulated;
+  cached.setInt("random_seed", 123);
+  cached.setBool("reset_cache", true);
+  cached.loadROM(argv[1]);
+  emulated.setInt("random_seed", 123);
+  emulated.loadROM(argv[1]);
+
+  int failures = 0;
+  for (int i = 0; i < NUM_RESETS; i++) {
+    cached.reset_game();
+    emulated.reset_game();
+    if (memcmp(cached.getRAM().array(), emulated.getRAM().array(), RAM_SIZE) != 0) {
+      failures++;
+    }
+  }
+
+  // Each power-on state is emulated once, every later reset is a hit
+  int hits = cached.environment->getNumResetCacheHits();
+  int misses = cached.environment->getNumResetCacheMisses();
+  if (hits + misses != NUM_RESETS + 1 || misses > NUM_POWER_ON_STATES) {
+    std::cerr << hits << " cache hits and " << misses << " misses over "
+              << NUM_RESETS + 1 << " resets" << std::endl;
+    return 1;
+  }
+  if (failures > 0) {
+    std::cerr << failures << " restored resets differ from emulated ones" << std::endl;
+    return 1;
+  }
+  std::cout << "resetCacheTest: OK (" << hits << " hits, " << misses << " misses)"
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,133 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  stateTreeTest.cpp
+ *
+ *  Grows a StateTree as a search agent would, stepping from random nodes, and
+ *  checks that every snapshot rebuilt from the delta chain matches the full
+ *  snapshot it was added from. Half the nodes are then released, the tree is
+ *  grown again over the freed space, and every remaining node is checked again.
+ *
+ *  Usage: stateTreeTest rom_file
+ **************************************************************************** */
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <ale_interface.hpp>
+
+// Small enough for the nodes to span many keyframes
+static const int KEYFRAME_INTERVAL = 16;
+
+static const int NUM_NODES = 3000;
+
+struct Search {
+  ALEInterface ale;
+  ActionVect actions;
+  StateTree tree;
+  std::vector<StateTree::NodeId> nodes;  // The nodes we hold a reference to
+  std::vector<ALESnapshot> snapshots;    // Their full snapshots
+  int failures;
+
+  Search(): tree(KEYFRAME_INTERVAL), failures(0) {}
+
+  // Checks that 'node' rebuilds into the snapshot at index 'i'
+  void check(size_t i, ALESnapshot& snapshot) {
+    tree.get(nodes[i], snapshot);
+    if (memcmp(&snapshot, &snapshots[i], sizeof(snapshot)) != 0) failures++;
+  }
+
+  // Mostly deepens the last node, as a rollout would, and sometimes branches
+  // from a random one
+  void grow(int count) {
+    ALESnapshot snapshot;
+    for (int k = 0; k < count; k++) {
+      size_t i = rand() % 4 == 0 ? rand() % nodes.size() : nodes.size() - 1;
+      check(i, snapshot);
+      ale.restoreState(snapshot);
+      ale.act(actions[rand() % actions.size()]);
+      if (ale.game_over()) ale.reset_game();
+
+      memset(&snapshot, 0, sizeof(snapshot));
+      ale.cloneState(snapshot);
+      nodes.push_back(tree.add(snapshot, nodes[i]));
+      snapshots.push_back(snapshot);
+    }
+  }
+
+  void checkAll() {
+    ALESnapshot snapshot;
+    for (size_t i = 0; i < nodes.size(); i++) {
+      check(i, snapshot);
+    }
+  }
+};
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " rom_file" << std::endl;
+    return 1;
+  }
+  ale::Logger::setMode(ale::Logger::Error);
+
+  Search search;
+  search.ale.setInt("random_seed", 123);
+  search.ale.loadROM(argv[1]);
+  search.actions = search.ale.getMinimalActionSet();
+  srand(7);
+
+  ALESnapshot root;
+  memset(&root, 0, sizeof(root));
+  if (!search.ale.cloneState(root)) {
+    std::cerr << "The ROM's state does not fit in a snapshot" << std::endl;
+    return 1;
+  }
+  search.nodes.push_back(search.tree.add(root));
+  search.snapshots.push_back(root);
+  search.grow(NUM_NODES - 1);
+  search.checkAll();
+
+  // Released nodes stay alive as long as their descendants are held
+  std::vector<StateTree::NodeId> kept_nodes;
+  std::vector<ALESnapshot> kept_snapshots;
+  for (size_t i = 0; i < search.nodes.size(); i++) {
+    if (i % 2 == 0) {
+      kept_nodes.push_back(search.nodes[i]);
+      kept_snapshots.push_back(search.snapshots[i]);
+    } else {
+      search.tree.release(search.nodes[i]);
+    }
+  }
+  search.nodes.swap(kept_nodes);
+  search.snapshots.swap(kept_snapshots);
+  if (search.tree.size() >= (size_t)NUM_NODES) {
+    std::cerr << "Releasing nodes did not free any" << std::endl;
+    return 1;
+  }
+  search.grow(NUM_NODES / 2);
+  search.checkAll();
+
+  for (size_t i = 0; i < search.nodes.size(); i++) {
+    search.tree.release(search.nodes[i]);
+  }
+  if (search.tree.size() != 0) {
+    std::cerr << search.tree.size() << " nodes left after releasing all of them" << std::endl;
+    return 1;
+  }
+
+  if (search.failures > 0) {
+    std::cerr << search.failures << " rebuilt snapshots differ from the full snapshots"
+              << std::endl;
+    return 1;
+  }
+  std::cout << "stateTreeTest: OK" << std::endl;
+  return 0;
+}
@@ -0,0 +1,94 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  trajectoryTest.cpp
+ *
+ *  Records a trajectory and checks that replaying it reproduces the RAM and
+ *  rewards of every step, linearly and when seeking.
+ *
+ *  Usage: trajectoryTest rom_file
+ **************************************************************************** */
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <ale_interface.hpp>
+
+static const int NUM_STEPS = 3000;
+
+static void configure(ALEInterface& ale, int seed) {
+  ale.setInt("random_seed", seed);
+  ale.setFloat("repeat_action_probability", 0.25);
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " rom_file" << std::endl;
+    return 1;
+  }
+  ale::Logger::setMode(ale::Logger::Error);
+
+  ALEInterface recorder;
+  configure(recorder, 123);
+  recorder.loadROM(argv[1]);
+  ActionVect actions = recorder.getMinimalActionSet();
+
+  // Record the RAM and reward after every step, with a reset halfway through
+  std::vector<std::vector<unsigned char> > rams;
+  std::vector<reward_t> rewards;
+  srand(7);
+  recorder.startRecording();
+  for (int i = 0; i < NUM_STEPS; i++) {
+    reward_t reward = 0;
+    if (i == NUM_STEPS / 2 || recorder.game_over()) {
+      recorder.reset_game();
+    } else {
+      reward = recorder.act(actions[rand() % actions.size()]);
+    }
+    const ALERAM& ram = recorder.getRAM();
+    rams.push_back(std::vector<unsigned char>(ram.array(), ram.array() + ram.size()));
+    rewards.push_back(reward);
+  }
+
+  // The player keeps its own copy of the trajectory returned by stopRecording()
+  ALEInterface replayer;
+  configure(replayer, 999);
+  replayer.loadROM(argv[1]);
+  TrajectoryPlayer player(replayer, recorder.stopRecording(), 250);
+
+  int failures = 0;
+  if (player.trajectory().size() != (size_t)NUM_STEPS) {
+    std::cerr << "Recorded " << player.trajectory().size() << " steps instead of "
+              << NUM_STEPS << std::endl;
+    return 1;
+  }
+  for (int i = 0; !player.done(); i++) {
+    reward_t reward = player.step();
+    if (reward != rewards[i] ||
+        memcmp(replayer.getRAM().array(), &rams[i][0], rams[i].size()) != 0) {
+      failures++;
+    }
+  }
+  for (int k = 0; k < 100; k++) {
+    size_t step = 1 + rand() % NUM_STEPS;
+    player.seek(step);
+    if (memcmp(replayer.getRAM().array(), &rams[step - 1][0], rams[step - 1].size()) != 0) {
+      failures++;
+    }
+  }
+
+  if (failures > 0) {
+    std::cerr << failures << " replayed steps differ from the recording" << std::endl;
+    return 1;
+  }
+  std::cout << "trajectoryTest: OK" << std::endl;
+  return 0;
+}
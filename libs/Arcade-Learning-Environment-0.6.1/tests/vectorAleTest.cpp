@@ -0,0 +1,101 @@
+/* *****************************************************************************
+ * A.L.E (Arcade Learning Environment)
+ * Copyright (c) 2009-2013 by Yavar Naddaf, Joel Veness, Marc G. Bellemare and
+ *   the Reinforcement Learning and Artificial Intelligence Laboratory
+ * Released under the GNU General Public License; see License.txt for details.
+ *
+ * Based on: Stella  --  "An Atari 2600 VCS Emulator"
+ * Copyright (c) 1995-2007 by Bradford W. Mott and the Stella team
+ *
+ * *****************************************************************************
+ *  vectorAleTest.cpp
+ *
+ *  Steps a VectorALE on a pool of threads next to one ALEInterface per
+ *  environment, seeded as the VectorALE seeds its own, and checks that the
+ *  reward, terminal flag, screen and RAM of every environment match after
+ *  every step, including the steps which end an episode.
+ *
+ *  Usage: vectorAleTest rom_file
+ **************************************************************************** */
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <ale_interface.hpp>
+#include <vector_ale.hpp>
+
+static const int NUM_ENVS = 4;
+
+// Fewer threads than environments, so that some threads step several
+static const int NUM_THREADS = 3;
+
+static const int NUM_STEPS = 3000;
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " rom_file" << std::endl;
+    return 1;
+  }
+  ale::Logger::setMode(ale::Logger::Error);
+
+  // Episodes end within the test
+  VectorALE vec(NUM_ENVS, NUM_THREADS);
+  vec.setInt("random_seed", 123);
+  vec.setInt("frame_skip", 4);
+  vec.loadROM(argv[1]);
+
+  // VectorALE gives environment i the seed random_seed + i
+  std::vector<std::unique_ptr<ALEInterface> > single;
+  for (int i = 0; i < NUM_ENVS; i++) {
+    single.push_back(std::unique_ptr<ALEInterface>(new ALEInterface()));
+    single[i]->setInt("random_seed", 123 + i);
+    single[i]->setInt("frame_skip", 4);
+    single[i]->loadROM(argv[1]);
+  }
+
+  ActionVect legal_actions = vec.getMinimalActionSet();
+  const size_t screen_size = vec.screenSize();
+  ActionVect actions(NUM_ENVS);
+  int failures = 0;
+  int terminals = 0;
+  srand(7);
+  for (int step = 0; step < NUM_STEPS; step++) {
+    for (int i = 0; i < NUM_ENVS; i++) {
+      actions[i] = legal_actions[rand() % legal_actions.size()];
+    }
+    vec.act(actions);
+
+    for (int i = 0; i < NUM_ENVS; i++) {
+      ALEInterface& ale = *single[i];
+      reward_t reward = ale.act(actions[i]);
+      bool terminal = ale.game_over();
+      if (terminal) {
+        ale.reset_game();
+        terminals++;
+      }
+      if (vec.getRewards()[i] != reward || (vec.getTerminals()[i] != 0) != terminal ||
+          memcmp(vec.getScreens() + i * screen_size, ale.getScreen().getArray(),
+                 screen_size) != 0 ||
+          memcmp(vec.getRAMs() + i * RAM_SIZE, ale.getRAM().array(), RAM_SIZE) != 0) {
+        if (failures == 0) {
+          std::cerr << "Environment " << i << " differs at step " << step << std::endl;
+        }
+        failures++;
+      }
+    }
+  }
+
+  if (failures > 0) {
+    std::cerr << failures << " environment steps differ from single environments"
+              << std::endl;
+    return 1;
+  }
+  if (terminals == 0) {
+    std::cerr << "No episode ended within " << NUM_STEPS << " steps" << std::endl;
+    return 1;
+  }
+  std::cout << "vectorAleTest: OK" << std::endl;
+  return 0;
+}
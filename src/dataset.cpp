@@ -0,0 +1,105 @@
+#include "dataset.hpp"
+#include <algorithm>
+#include <charconv>  // std::from_chars
+#include <fstream>
+#include <iterator>
+#include "game_log.hpp"
+
+Dataset::Dataset(size_t numFeatures)
+    : numFeatures(numFeatures) {}
+
+void Dataset::addRow(const float* values, int label) {
+    features.insert(features.end(), values, values + numFeatures);
+    labels.push_back(label);
+    ++numRows;
+}
+
+void Dataset::append(const Dataset& other) {
+    features.insert(features.end(), other.features.begin(), other.features.end());
+    labels.insert(labels.end(), other.labels.begin(), other.labels.end());
+    numRows += other.numRows;
+}
+
+int Dataset::numClasses() const {
+    if (labels.empty()) return 0;
+    return *std::max_element(labels.begin(), labels.end()) + 1;
+}
+
+// Cargar los datos de la partida
+bool loadGameData(const std::string& path, Dataset& data) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // Leer el archivo de una vez y recorrerlo sin streams: con millones de
+    // filas, stringstream por línea es lo que más tarda
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const char* p = text.data();
+    const char* end = p + text.size();
+
+    // Ignorar la cabecera
+    p = std::find(p, end, '\n');
+    if (p != end) ++p;
+
+    data = Dataset(3);  // player_x, enemy_x, enemy_y
+    data.features.reserve(std::count(p, end, '\n') * data.numFeatures);
+
+    const float max_value = 255.0f;  // Rango de un byte de la RAM
+    while (p < end) {
+        int values[5];  // frame, player_x, enemy_x, enemy_y, action
+        int n = 0;
+        while (n < 5) {
+            auto result = std::from_chars(p, end, values[n]);
+            if (result.ec != std::errc()) break;
+            p = result.ptr;
+            ++n;
+            if (p < end && *p == ',') ++p;
+        }
+
+        if (n == 5 && values[4] >= 0 && values[4] < NUM_ACTIONS) {
+            float input[3] = {values[1] / max_value, values[2] / max_value, values[3] / max_value};
+            data.addRow(input, values[4]);
+        }
+
+        // Pasar a la siguiente línea (también si esta estaba mal formada)
+        p = std::find(p, end, '\n');
+        if (p != end) ++p;
+    }
+
+    return true;
+}
+
+// Cargar un registro binario de partidas
+bool loadGameLog(const std::string& path, Dataset& data) {
+    GameLogReader log;
+    if (!log.open(path)) {
+        return false;
+    }
+
+    data = Dataset(log.numFeatures());
+    data.features.resize(log.numRows() * data.numFeatures);
+    data.labels.resize(log.numRows());
+    data.numRows = log.numRows();
+
+    // Las columnas de cada bloque se leen directamente del archivo proyectado
+    const float max_value = 255.0f;
+    size_t row = 0;
+    for (size_t b = 0; b < log.numBlocks(); ++b) {
+        GameLogBlock block = log.block(b);
+        for (size_t k = 0; k < data.numFeatures; ++k) {
+            const uint8_t* column = block.feature(k);
+            float* out = &data.features[row * data.numFeatures + k];
+            for (size_t i = 0; i < block.rows; ++i) {
+                out[i * data.numFeatures] = column[i] / max_value;
+            }
+        }
+        for (size_t i = 0; i < block.rows; ++i) {
+            if (block.action[i] >= NUM_ACTIONS) return false;
+            data.labels[row + i] = block.action[i];
+        }
+        row += block.rows;
+    }
+
+    return true;
+}
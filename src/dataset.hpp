@@ -0,0 +1,46 @@
+#ifndef DATASET_HPP
+#define DATASET_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Número de acciones de ALE (PLAYER_A_NOOP a PLAYER_A_DOWNLEFTFIRE): las
+// etiquetas válidas están en [0, NUM_ACTIONS)
+const int NUM_ACTIONS = 18;
+
+// Conjunto de ejemplos en una única matriz contigua, fila a fila
+struct Dataset {
+    size_t numRows = 0;
+    size_t numFeatures = 0;
+    std::vector<float> features;  // numRows * numFeatures valores
+    std::vector<int> labels;      // Acción de cada fila
+
+    explicit Dataset(size_t numFeatures = 0);
+
+    // Añadir una fila con numFeatures valores y su etiqueta
+    void addRow(const float* values, int label);
+
+    // Añadir todas las filas de otro conjunto con el mismo número de entradas
+    void append(const Dataset& other);
+
+    // Puntero a la fila i
+    const float* row(size_t i) const { return &features[i * numFeatures]; }
+
+    // Número de clases: mayor etiqueta + 1
+    int numClasses() const;
+};
+
+// Cargar un CSV de partidas (frame,player_x,enemy_x,enemy_y,action), como los
+// que export_log obtiene de un registro binario; las columnas que sigan a la
+// acción se ignoran. Las tres posiciones, normalizadas a [0, 1], son las
+// entradas y la acción la etiqueta.
+// Las filas mal formadas o con una acción fuera de [0, NUM_ACTIONS) se ignoran
+bool loadGameData(const std::string& path, Dataset& data);
+
+// Cargar un registro binario (game_log.hpp): los bytes de RAM registrados,
+// normalizados a [0, 1], son las entradas y la acción la etiqueta. Un registro
+// con acciones fuera de [0, NUM_ACTIONS) está corrupto y se rechaza
+bool loadGameLog(const std::string& path, Dataset& data);
+
+#endif
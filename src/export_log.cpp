@@ -0,0 +1,70 @@
+#include <iostream>
+#include <fstream>
+#include <charconv>  // std::to_chars
+#include <string>
+#include "game_log.hpp"
+
+using namespace std;
+
+// Añadir un número y un separador al texto de salida
+template <typename T>
+void appendValue(string& out, T value, char separator) {
+    char buffer[16];
+    auto result = to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+    out.push_back(separator);
+}
+
+// Exportar un registro binario de partidas a CSV, para inspeccionarlo
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        cerr << "Uso: " << argv[0] << " <registro.bin> [salida.csv]" << endl;
+        return 1;
+    }
+
+    GameLogReader log;
+    if (!log.open(argv[1])) {
+        cerr << "Error al abrir el registro: " << argv[1] << endl;
+        return 1;
+    }
+
+    // Sin archivo de salida, se escribe por la salida estándar
+    ofstream outFile;
+    if (argc == 3) {
+        outFile.open(argv[2], ios::binary);
+        if (!outFile.is_open()) {
+            cerr << "Error al crear el archivo CSV: " << argv[2] << endl;
+            return 1;
+        }
+    }
+    ostream& out = argc == 3 ? outFile : cout;
+
+    // Cabecera: las columnas de RAM se nombran por su dirección
+    string text = "frame,";
+    for (size_t k = 0; k < log.numFeatures(); ++k) {
+        text += "ram_" + to_string(log.featureAddress(k)) + ",";
+    }
+    text += "action,reward\n";
+
+    // Se vuelca bloque a bloque, para no formatear todo el registro en memoria
+    for (size_t b = 0; b < log.numBlocks(); ++b) {
+        GameLogBlock block = log.block(b);
+        for (size_t i = 0; i < block.rows; ++i) {
+            appendValue(text, block.frame[i], ',');
+            for (size_t k = 0; k < log.numFeatures(); ++k) {
+                appendValue(text, block.feature(k)[i], ',');
+            }
+            appendValue(text, block.action[i], ',');
+            appendValue(text, block.reward[i], '\n');
+        }
+        out.write(text.data(), text.size());
+        text.clear();
+    }
+
+    out.flush();
+    if (!out) {
+        cerr << "Error al escribir el CSV." << endl;
+        return 1;
+    }
+    return 0;
+}
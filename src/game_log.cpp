@@ -0,0 +1,175 @@
+#include "game_log.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+size_t gameLogBlockSize(size_t rows, size_t numFeatures) {
+    size_t bytes = sizeof(GameLogBlockHeader) + rows * (sizeof(uint32_t) + sizeof(int32_t))
+                 + rows * (numFeatures + 1);
+    return (bytes + 7) & ~static_cast<size_t>(7);
+}
+
+GameLogWriter::~GameLogWriter() {
+    close();
+}
+
+bool GameLogWriter::open(const std::string& path, const std::vector<uint8_t>& featureAddress,
+                         uint32_t blockRows) {
+    if (featureAddress.empty() || featureAddress.size() > GAME_LOG_MAX_FEATURES || blockRows == 0) {
+        return false;
+    }
+
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    header = GameLogHeader{};
+    std::memcpy(header.magic, GAME_LOG_MAGIC, sizeof(header.magic));
+    header.version = GAME_LOG_VERSION;
+    header.blockRows = blockRows;
+    header.numFeatures = static_cast<uint32_t>(featureAddress.size());
+    std::copy(featureAddress.begin(), featureAddress.end(), header.featureAddress);
+
+    // La cabecera se reescribe al cerrar, con el número de filas definitivo
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    frames.clear();
+    rewards.clear();
+    actions.clear();
+    features.assign(static_cast<size_t>(blockRows) * header.numFeatures, 0);
+    return file.good();
+}
+
+void GameLogWriter::append(uint32_t frame, const uint8_t* values, uint8_t action, int32_t reward) {
+    size_t row = frames.size();
+    for (size_t k = 0; k < header.numFeatures; ++k) {
+        features[k * header.blockRows + row] = values[k];
+    }
+    frames.push_back(frame);
+    rewards.push_back(reward);
+    actions.push_back(action);
+    ++header.numRows;
+
+    if (frames.size() == header.blockRows) {
+        flushBlock();
+    }
+}
+
+void GameLogWriter::flushBlock() {
+    uint32_t rows = static_cast<uint32_t>(frames.size());
+    if (rows == 0) return;
+
+    GameLogBlockHeader blockHeader{rows, 0};
+    file.write(reinterpret_cast<const char*>(&blockHeader), sizeof(blockHeader));
+    file.write(reinterpret_cast<const char*>(frames.data()), rows * sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(rewards.data()), rows * sizeof(int32_t));
+    for (size_t k = 0; k < header.numFeatures; ++k) {
+        file.write(reinterpret_cast<const char*>(&features[k * header.blockRows]), rows);
+    }
+    file.write(reinterpret_cast<const char*>(actions.data()), rows);
+
+    // Relleno para que el siguiente bloque empiece alineado
+    static const char padding[8] = {};
+    size_t written = sizeof(blockHeader) + rows * (sizeof(uint32_t) + sizeof(int32_t))
+                   + rows * (header.numFeatures + 1);
+    file.write(padding, gameLogBlockSize(rows, header.numFeatures) - written);
+
+    frames.clear();
+    rewards.clear();
+    actions.clear();
+}
+
+bool GameLogWriter::close() {
+    if (!file.is_open()) return true;
+
+    flushBlock();
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    bool ok = file.good();
+    file.close();
+    return ok;
+}
+
+GameLogReader::~GameLogReader() {
+    close();
+}
+
+bool GameLogReader::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(GameLogHeader)) {
+        ::close(fd);
+        return false;
+    }
+
+    size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // La proyección sigue siendo válida sin el descriptor
+    if (mapping == MAP_FAILED) {
+        size = 0;
+        return false;
+    }
+    base = static_cast<const unsigned char*>(mapping);
+    header = reinterpret_cast<const GameLogHeader*>(base);
+
+    // Comprobar la cabecera y que el archivo contiene todos los bloques
+    bool valid = std::memcmp(header->magic, GAME_LOG_MAGIC, sizeof(header->magic)) == 0
+              && header->version == GAME_LOG_VERSION
+              && header->blockRows > 0
+              && header->numFeatures > 0 && header->numFeatures <= GAME_LOG_MAX_FEATURES;
+    if (valid) {
+        size_t fullBlocks = header->numRows / header->blockRows;
+        size_t lastRows = header->numRows % header->blockRows;
+        size_t expected = sizeof(GameLogHeader)
+                        + fullBlocks * gameLogBlockSize(header->blockRows, header->numFeatures)
+                        + (lastRows ? gameLogBlockSize(lastRows, header->numFeatures) : 0);
+        valid = size >= expected;
+    }
+    if (!valid) {
+        close();
+        return false;
+    }
+
+    // Lectura secuencial: que el sistema adelante páginas
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    return true;
+}
+
+void GameLogReader::close() {
+    if (base) {
+        munmap(const_cast<unsigned char*>(base), size);
+    }
+    base = nullptr;
+    header = nullptr;
+    size = 0;
+}
+
+size_t GameLogReader::numBlocks() const {
+    return (header->numRows + header->blockRows - 1) / header->blockRows;
+}
+
+GameLogBlock GameLogReader::block(size_t i) const {
+    size_t numFeatures = header->numFeatures;
+    const unsigned char* p = base + sizeof(GameLogHeader)
+                           + i * gameLogBlockSize(header->blockRows, numFeatures);
+    // Filas calculadas desde la cabecera: open() ya comprobó que caben en el archivo
+    size_t rows = std::min<size_t>(header->blockRows, header->numRows - i * header->blockRows);
+    p += sizeof(GameLogBlockHeader);
+
+    GameLogBlock block;
+    block.rows = rows;
+    block.frame = reinterpret_cast<const uint32_t*>(p);
+    block.reward = reinterpret_cast<const int32_t*>(p + rows * sizeof(uint32_t));
+    block.features = p + rows * (sizeof(uint32_t) + sizeof(int32_t));
+    block.action = block.features + rows * numFeatures;
+    return block;
+}
@@ -0,0 +1,111 @@
+#ifndef GAME_LOG_HPP
+#define GAME_LOG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Registro binario de partidas, por columnas (little-endian):
+//
+//   Cabecera (64 bytes): GameLogHeader
+//   Bloques: GameLogBlockHeader seguido de las columnas de sus filas
+//     frame   uint32[rows]
+//     reward  int32[rows]
+//     feature uint8[rows], una columna por byte de RAM registrado
+//     action  uint8[rows]
+//     relleno hasta múltiplo de 8 bytes
+//
+// Todos los bloques tienen blockRows filas salvo el último, así que la
+// posición de cada bloque se calcula sin recorrer el archivo.
+
+const char GAME_LOG_MAGIC[8] = {'D', 'A', 'G', 'L', 'O', 'G', '\0', '\0'};
+const uint32_t GAME_LOG_VERSION = 1;
+const size_t GAME_LOG_MAX_FEATURES = 32;
+
+struct GameLogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t blockRows;    // Filas por bloque
+    uint64_t numRows;      // Se escribe al cerrar el registro
+    uint32_t numFeatures;  // Bytes de RAM registrados en cada fila
+    uint8_t featureAddress[GAME_LOG_MAX_FEATURES];  // Dirección de cada uno
+    uint8_t reserved[4];
+};
+static_assert(sizeof(GameLogHeader) == 64, "La cabecera del registro debe ocupar 64 bytes");
+
+struct GameLogBlockHeader {
+    uint32_t rows;
+    uint32_t reserved;
+};
+
+// Tamaño en bytes de un bloque con rows filas
+size_t gameLogBlockSize(size_t rows, size_t numFeatures);
+
+// Escritura del registro, bloque a bloque
+class GameLogWriter {
+public:
+    GameLogWriter() = default;
+    ~GameLogWriter();
+    GameLogWriter(const GameLogWriter&) = delete;
+    GameLogWriter& operator=(const GameLogWriter&) = delete;
+
+    // Crear el archivo; featureAddress son las direcciones de RAM de cada fila
+    bool open(const std::string& path, const std::vector<uint8_t>& featureAddress,
+              uint32_t blockRows = 4096);
+
+    // Añadir una fila: numFeatures bytes de RAM, la acción y su recompensa
+    void append(uint32_t frame, const uint8_t* features, uint8_t action, int32_t reward);
+
+    // Escribir el último bloque y el número de filas en la cabecera
+    bool close();
+
+private:
+    void flushBlock();
+
+    std::ofstream file;
+    GameLogHeader header{};
+    std::vector<uint32_t> frames;
+    std::vector<int32_t> rewards;
+    std::vector<uint8_t> features;  // Columna a columna, blockRows bytes cada una
+    std::vector<uint8_t> actions;
+};
+
+// Columnas de un bloque, apuntando directamente al archivo proyectado
+struct GameLogBlock {
+    size_t rows;
+    const uint32_t* frame;
+    const int32_t* reward;
+    const uint8_t* features;  // Columna k en features + k * rows
+    const uint8_t* action;
+
+    const uint8_t* feature(size_t k) const { return features + k * rows; }
+};
+
+// Lectura del registro con mmap, sin copiar los datos
+class GameLogReader {
+public:
+    GameLogReader() = default;
+    ~GameLogReader();
+    GameLogReader(const GameLogReader&) = delete;
+    GameLogReader& operator=(const GameLogReader&) = delete;
+
+    // Proyectar el archivo en memoria y comprobar la cabecera
+    bool open(const std::string& path);
+    void close();
+
+    size_t numRows() const { return header->numRows; }
+    size_t numFeatures() const { return header->numFeatures; }
+    uint8_t featureAddress(size_t k) const { return header->featureAddress[k]; }
+    size_t numBlocks() const;
+
+    GameLogBlock block(size_t i) const;
+
+private:
+    const unsigned char* base = nullptr;
+    size_t size = 0;
+    const GameLogHeader* header = nullptr;
+};
+
+#endif
@@ -1,13 +1,30 @@
 #include <ale_interface.hpp>
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
 #include <vector>
-#include <fstream>
 #include <cstdlib>
+#include "game_log.hpp"
 #include "perceptron.hpp"
 
 using namespace std;
 
-int main() {
+// Bytes de RAM que se registran en cada frame
+const vector<uint8_t> featureAddress = {20, 30, 31};  // player_x, enemy_x, enemy_y
+
+// Leer el estado del juego desde la RAM
+void readFeatures(const ALERAM& ram, uint8_t* features) {
+    features[0] = ram.get(featureAddress[0]);  // Propuesta: posición X del jugador
+    features[1] = ram.get(featureAddress[1]);  // Propuesta: posición X del enemigo
+    features[2] = ram.get(featureAddress[2]);  // Propuesta: posición Y del enemigo
+}
+
+// Una partida con pantalla, mostrando la puntuación en cada frame
+int playInteractive(const string& romPath) {
     // Inicializar ALE
     ALEInterface ale;
 
@@ -17,7 +34,6 @@ int main() {
     ale.setFloat("repeat_action_probability", 0.25);
 
     // Cargar la ROM
-    string romPath = "/home/cpc/Escritorio/atascaburrasStudios-P2/roms/demon_attack.bin";
     try {
         ale.loadROM(romPath);
         cout << "ROM cargada con éxito: " << romPath << endl;
@@ -29,47 +45,184 @@ int main() {
     // Obtener las acciones legales
     vector<Action> legalActions = ale.getLegalActionSet();
 
-    // Mostrar el tamaño de la RAM
-    auto ram = ale.getRAM();
+    // Vista de solo lectura sobre la RAM: se actualiza sola en cada frame, sin copias
+    const ALERAM& ram = ale.getRAM();
     cout << "Tamaño de la RAM: " << ram.size() << endl;
 
-    // Crear el archivo de datos
-    ofstream dataFile("data/game_data.csv");
-    if (!dataFile.is_open()) {
+    // Crear el registro de datos: frame, bytes de RAM, acción y recompensa, por
+    // columnas (se puede pasar a CSV con export_log)
+    GameLogWriter dataLog;
+    if (!dataLog.open("data/game_data.bin", featureAddress)) {
         cerr << "Error al abrir el archivo de datos." << endl;
         return 1;
     }
-    dataFile << "frame,player_x,enemy_x,enemy_y,action\n";
 
     int score = 0;
 
     // Bucle principal del juego
     while (!ale.game_over()) {
-        // Obtener el estado del juego desde la RAM
-        int player_x = ram.get(20);  // Propuesta: posición X del jugador
-        int enemy_x = ram.get(30);  // Propuesta: posición X del enemigo
-        int enemy_y = ram.get(31);  // Propuesta: posición Y del enemigo
+        uint8_t features[3];
+        readFeatures(ram, features);
 
         // Seleccionar una acción aleatoria
         Action action = legalActions[rand() % legalActions.size()];
-        score += ale.act(action);
+        reward_t reward = ale.act(action);
+        score += reward;
 
-        // Guardar los datos en el archivo
-        dataFile << ale.getEpisodeFrameNumber() << ","
-                 << player_x << ","
-                 << enemy_x << ","
-                 << enemy_y << ","
-                 << action << "\n";
+        // Guardar los datos en el registro
+        dataLog.append(ale.getEpisodeFrameNumber(), features, static_cast<uint8_t>(action), reward);
 
         // Mostrar la puntuación actual
         cout << "Frame: " << ale.getEpisodeFrameNumber()
              << " | Puntuación: " << score << endl;
     }
 
-    dataFile.close();
+    if (!dataLog.close()) {
+        cerr << "Error al guardar el archivo de datos." << endl;
+        return 1;
+    }
 
     // Mensaje final
     cout << "Fin del juego. Puntuación final: " << score << endl;
 
     return 0;
 }
+
+// Contadores compartidos por los hilos de recogida; cada hilo solo suma
+struct CollectProgress {
+    atomic<uint64_t> frames{0};
+    atomic<uint64_t> episodes{0};
+    atomic<int> running{0};
+    atomic<bool> failed{false};
+};
+
+// Hilo de recogida: sus propias partidas, su semilla y su registro
+void collectWorker(const string& romPath, int worker, int episodes, int seed,
+                   CollectProgress& progress) {
+    // Cada hilo crea y carga su propia instancia de ALE, en paralelo
+    unique_ptr<ALEInterface> ale(new ALEInterface());
+    ale->setBool("display_screen", false);
+    ale->setInt("random_seed", seed + worker);
+    ale->setFloat("repeat_action_probability", 0.25);
+    // Solo se registra la RAM: no hace falta dibujar ningún frame
+    ale->setString("render_mode", "never");
+    try {
+        ale->loadROM(romPath);
+    } catch (const exception &e) {
+        cerr << "Error al cargar la ROM: " << e.what() << endl;
+        progress.failed = true;
+        --progress.running;
+        return;
+    }
+
+    string logPath = "data/game_data_" + to_string(worker) + ".bin";
+    GameLogWriter dataLog;
+    if (!dataLog.open(logPath, featureAddress)) {
+        cerr << "Error al abrir el archivo de datos: " << logPath << endl;
+        progress.failed = true;
+        --progress.running;
+        return;
+    }
+
+    vector<Action> legalActions = ale->getLegalActionSet();
+    const ALERAM& ram = ale->getRAM();
+    mt19937 rng(seed + worker);
+    uniform_int_distribution<size_t> pick(0, legalActions.size() - 1);
+
+    for (int episode = 0; episode < episodes; ++episode) {
+        // Los frames se suman en lotes para no tocar el contador en cada uno
+        uint64_t frames = 0;
+        while (!ale->game_over()) {
+            uint8_t features[3];
+            readFeatures(ram, features);
+
+            Action action = legalActions[pick(rng)];
+            reward_t reward = ale->act(action);
+            dataLog.append(ale->getEpisodeFrameNumber(), features, static_cast<uint8_t>(action), reward);
+
+            if (++frames == 1024) {
+                progress.frames.fetch_add(frames, memory_order_relaxed);
+                frames = 0;
+            }
+        }
+        progress.frames.fetch_add(frames, memory_order_relaxed);
+        progress.episodes.fetch_add(1, memory_order_relaxed);
+        ale->reset_game();
+    }
+
+    if (!dataLog.close()) {
+        cerr << "Error al guardar el archivo de datos: " << logPath << endl;
+        progress.failed = true;
+    }
+    --progress.running;
+}
+
+// Recogida sin pantalla: numWorkers partidas en paralelo, cada una en su
+// propio registro data/game_data_<hilo>.bin
+int collect(const string& romPath, int numWorkers, int episodes, int seed) {
+    ale::Logger::setMode(ale::Logger::Error);
+
+    CollectProgress progress;
+    progress.running = numWorkers;
+    vector<thread> workers;
+    for (int w = 0; w < numWorkers; ++w) {
+        workers.emplace_back(collectWorker, cref(romPath), w, episodes, seed, ref(progress));
+    }
+
+    // Progreso agregado, una línea por segundo
+    auto start = chrono::steady_clock::now();
+    auto nextReport = start + chrono::seconds(1);
+    uint64_t totalEpisodes = static_cast<uint64_t>(numWorkers) * episodes;
+    while (progress.running > 0) {
+        this_thread::sleep_for(chrono::milliseconds(100));
+        auto now = chrono::steady_clock::now();
+        if (now < nextReport) continue;
+        nextReport += chrono::seconds(1);
+
+        double seconds = chrono::duration<double>(now - start).count();
+        uint64_t frames = progress.frames.load(memory_order_relaxed);
+        cout << "Frames: " << frames << " (" << static_cast<uint64_t>(frames / seconds) << "/s)"
+             << " | Episodios: " << progress.episodes.load(memory_order_relaxed)
+             << "/" << totalEpisodes << endl;
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Recogida terminada: " << progress.frames.load() << " frames y "
+         << progress.episodes.load() << " episodios en " << seconds << " s" << endl;
+    return progress.failed ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    string romPath = "/home/cpc/Escritorio/atascaburrasStudios-P2/roms/demon_attack.bin";
+
+    // Sin argumentos: una partida con pantalla. Con --collect: recogida en paralelo
+    int numWorkers = 0;
+    int episodes = 1;
+    int seed = 123;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--collect") {
+            if (numWorkers <= 0) numWorkers = max(1u, thread::hardware_concurrency());
+        } else if (arg == "--workers" && i + 1 < argc) {
+            numWorkers = atoi(argv[++i]);
+        } else if (arg == "--episodes" && i + 1 < argc) {
+            episodes = atoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = atoi(argv[++i]);
+        } else if (arg == "--rom" && i + 1 < argc) {
+            romPath = argv[++i];
+        } else {
+            cerr << "Uso: " << argv[0] << " [--rom ruta] [--collect] [--workers N]"
+                 << " [--episodes N] [--seed N]" << endl;
+            return 1;
+        }
+    }
+
+    if (numWorkers <= 0) {
+        return playInteractive(romPath);
+    }
+    return collect(romPath, numWorkers, max(episodes, 1), seed);
+}
@@ -1,44 +1,371 @@
 #include "perceptron.hpp"
-#include <numeric>  // std::inner_product
+#include <algorithm>
+#include <numeric>    // std::iota
 #include <stdexcept>  // Para std::invalid_argument
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PERCEPTRON_AVX2
+#endif
+
+namespace {
+
+// Núcleos de cálculo; classStride y n son múltiplos de 8
+struct Kernels {
+    void (*scores)(const float* weights, const float* bias, const float* x, int numInputs,
+                   size_t classStride, float* out);
+    void (*scoresBatch)(const float* weights, const float* bias, const float* x, size_t rows,
+                        int numInputs, size_t classStride, float* out);
+    void (*addScaled)(float* dst, const float* x, float scale, size_t n);
+};
+
+// out = bias + suma de x[j] por los pesos de la entrada j, para todas las clases
+void scoresScalar(const float* weights, const float* bias, const float* x, int numInputs,
+                  size_t classStride, float* out) {
+    std::copy(bias, bias + classStride, out);
+    for (int j = 0; j < numInputs; ++j) {
+        const float* w = weights + j * classStride;
+        for (size_t c = 0; c < classStride; ++c) {
+            out[c] += x[j] * w[c];
+        }
+    }
+}
+
+// Puntuaciones de rows filas consecutivas; la de la fila r empieza en out + r * classStride
+void scoresBatchScalar(const float* weights, const float* bias, const float* x, size_t rows,
+                       int numInputs, size_t classStride, float* out) {
+    for (size_t r = 0; r < rows; ++r) {
+        scoresScalar(weights, bias, x + r * numInputs, numInputs, classStride, out + r * classStride);
+    }
+}
+
+void addScaledScalar(float* dst, const float* x, float scale, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] += scale * x[i];
+    }
+}
+
+#ifdef PERCEPTRON_AVX2
+// Las puntuaciones de 8 clases se acumulan en un registro mientras se recorren las entradas
+__attribute__((target("avx2,fma")))
+void scoresAVX2(const float* weights, const float* bias, const float* x, int numInputs,
+                size_t classStride, float* out) {
+    for (size_t c = 0; c < classStride; c += 8) {
+        __m256 acc = _mm256_loadu_ps(bias + c);
+        for (int j = 0; j < numInputs; ++j) {
+            acc = _mm256_fmadd_ps(_mm256_set1_ps(x[j]),
+                                  _mm256_loadu_ps(weights + j * classStride + c), acc);
+        }
+        _mm256_storeu_ps(out + c, acc);
+    }
+}
+
+// Cuatro filas a la vez: cada vector de pesos se carga una vez y se usa en
+// cuatro acumuladores, así los pesos se leen de memoria 4 veces menos
+__attribute__((target("avx2,fma")))
+void scoresBatchAVX2(const float* weights, const float* bias, const float* x, size_t rows,
+                     int numInputs, size_t classStride, float* out) {
+    size_t r = 0;
+    for (; r + 4 <= rows; r += 4) {
+        const float* x0 = x + r * numInputs;
+        const float* x1 = x0 + numInputs;
+        const float* x2 = x1 + numInputs;
+        const float* x3 = x2 + numInputs;
+        for (size_t c = 0; c < classStride; c += 8) {
+            __m256 acc0 = _mm256_loadu_ps(bias + c);
+            __m256 acc1 = acc0;
+            __m256 acc2 = acc0;
+            __m256 acc3 = acc0;
+            for (int j = 0; j < numInputs; ++j) {
+                __m256 w = _mm256_loadu_ps(weights + j * classStride + c);
+                acc0 = _mm256_fmadd_ps(_mm256_set1_ps(x0[j]), w, acc0);
+                acc1 = _mm256_fmadd_ps(_mm256_set1_ps(x1[j]), w, acc1);
+                acc2 = _mm256_fmadd_ps(_mm256_set1_ps(x2[j]), w, acc2);
+                acc3 = _mm256_fmadd_ps(_mm256_set1_ps(x3[j]), w, acc3);
+            }
+            float* o = out + r * classStride + c;
+            _mm256_storeu_ps(o, acc0);
+            _mm256_storeu_ps(o + classStride, acc1);
+            _mm256_storeu_ps(o + 2 * classStride, acc2);
+            _mm256_storeu_ps(o + 3 * classStride, acc3);
+        }
+    }
+    for (; r < rows; ++r) {
+        scoresAVX2(weights, bias, x + r * numInputs, numInputs, classStride, out + r * classStride);
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void addScaledAVX2(float* dst, const float* x, float scale, size_t n) {
+    const __m256 s = _mm256_set1_ps(scale);
+    for (size_t i = 0; i < n; i += 8) {
+        _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(s, _mm256_loadu_ps(x + i), _mm256_loadu_ps(dst + i)));
+    }
+}
+#endif
+
+// Elegir los núcleos una sola vez, según lo que soporte la CPU
+Kernels selectKernels() {
+    Kernels kernels = {scoresScalar, scoresBatchScalar, addScaledScalar};
+#ifdef PERCEPTRON_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        kernels.scores = scoresAVX2;
+        kernels.scoresBatch = scoresBatchAVX2;
+        kernels.addScaled = addScaledAVX2;
+    }
+#endif
+    return kernels;
+}
+
+const Kernels& kernels() {
+    static const Kernels k = selectKernels();
+    return k;
+}
+
+// Redondear n a múltiplo de 8, para trabajar con vectores completos de 8 floats
+size_t paddedSize(size_t n) {
+    return (n + 7) & ~static_cast<size_t>(7);
+}
+
+// Filas que se puntúan de una vez en predictBatch: sus puntuaciones caben
+// holgadamente en la caché L1 junto a los pesos de un perceptrón pequeño
+const size_t BATCH_TILE = 64;
+
+// Reparto de n elementos en partes casi iguales: inicio de la parte i
+size_t shardBegin(size_t n, int parts, int i) {
+    return n * i / parts;
+}
+
+}  // namespace
 
 // Constructor
-Perceptron::Perceptron(int numInputs, float learningRate)
-    : learningRate(learningRate), bias(0.0f) {
-    weights.resize(numInputs, 0.0f);  // Inicializa los pesos en 0
+Perceptron::Perceptron(int numInputs, int numClasses, float learningRate)
+    : numInputs(numInputs), numClasses(numClasses), classStride(paddedSize(numClasses)),
+      learningRate(learningRate) {
+    if (numInputs <= 0 || numClasses <= 0) {
+        throw std::invalid_argument("El perceptrón necesita al menos una entrada y una clase.");
+    }
+    weights.resize(numInputs * classStride, 0.0f);  // Inicializa los pesos en 0
+    bias.resize(classStride, 0.0f);
+}
+
+void Perceptron::scores(const float* inputs, float* out) const {
+    kernels().scores(weights.data(), bias.data(), inputs, numInputs, classStride, out);
 }
 
 // Predicción
-int Perceptron::predict(const std::vector<float>& inputs) {
-    // Producto interno entre pesos y entradas, más el sesgo
-    float sum = std::inner_product(weights.begin(), weights.end(), inputs.begin(), bias);
+int Perceptron::predict(const float* inputs) const {
+    // Producto interno entre las entradas y los pesos de cada clase, más su sesgo
+    float out[64];
+    std::vector<float> large;
+    float* score = out;
+    if (classStride > 64) {
+        large.resize(classStride);
+        score = large.data();
+    }
+    scores(inputs, score);
+
+    return static_cast<int>(std::max_element(score, score + numClasses) - score);
+}
 
-    // Activación binaria: devuelve 1 si la suma es mayor o igual a 0, de lo contrario, 0
-    return (sum >= 0.0f) ? 1 : 0;
+int Perceptron::predict(const std::vector<float>& inputs) const {
+    if (inputs.size() != static_cast<size_t>(numInputs)) {
+        throw std::invalid_argument("El tamaño de la entrada no coincide con el número de entradas del perceptrón.");
+    }
+    return predict(inputs.data());
+}
+
+// Predicción por lotes
+void Perceptron::predictBatch(const float* inputs, size_t numRows, int* actions) const {
+    std::vector<float> score(batchScoreSize());
+    predictBatch(inputs, numRows, actions, score.data());
+}
+
+size_t Perceptron::batchScoreSize() const {
+    return BATCH_TILE * classStride;
+}
+
+void Perceptron::predictBatch(const float* inputs, size_t numRows, int* actions,
+                              float* score) const {
+    const Kernels& k = kernels();
+    for (size_t start = 0; start < numRows; start += BATCH_TILE) {
+        size_t rows = std::min(BATCH_TILE, numRows - start);
+        k.scoresBatch(weights.data(), bias.data(), inputs + start * numInputs, rows,
+                      numInputs, classStride, score);
+
+        // La acción de cada fila es la clase con mayor puntuación
+        for (size_t r = 0; r < rows; ++r) {
+            const float* s = &score[r * classStride];
+            actions[start + r] = static_cast<int>(std::max_element(s, s + numClasses) - s);
+        }
+    }
 }
 
 // Entrenamiento
 void Perceptron::train(const std::vector<float>& inputs, int target) {
+    if (target < 0 || target >= numClasses) {
+        throw std::invalid_argument("La acción esperada está fuera de las clases del perceptrón.");
+    }
     int prediction = predict(inputs);   // Predicción actual
-    int error = target - prediction;   // Error entre predicción y objetivo
+    if (prediction == target) return;
 
-    // Ajuste de pesos basado en el error
-    for (size_t i = 0; i < weights.size(); ++i) {
-        weights[i] += learningRate * error * inputs[i];
+    // Acercar la clase correcta a la entrada y alejar la predicha
+    for (int j = 0; j < numInputs; ++j) {
+        weights[j * classStride + target] += learningRate * inputs[j];
+        weights[j * classStride + prediction] -= learningRate * inputs[j];
     }
-    bias += learningRate * error;  // Ajuste del sesgo
+    bias[target] += learningRate;
+    bias[prediction] -= learningRate;
+}
+
+size_t Perceptron::trainShard(const Dataset& data, const std::vector<size_t>& order,
+                              size_t begin, size_t end, size_t batchSize) {
+    const Kernels& k = kernels();
+    std::vector<float> deltaWeights(weights.size());
+    std::vector<float> deltaBias(bias.size());
+    size_t errors = 0;
+
+    for (size_t start = begin; start < end; start += batchSize) {
+        size_t stop = std::min(start + batchSize, end);
+        std::fill(deltaWeights.begin(), deltaWeights.end(), 0.0f);
+        std::fill(deltaBias.begin(), deltaBias.end(), 0.0f);
+        bool changed = false;
+
+        // Todas las filas del lote se evalúan con los mismos pesos
+        for (size_t i = start; i < stop; ++i) {
+            const float* x = data.row(order[i]);
+            int target = data.labels[order[i]];
+            int prediction = predict(x);
+            if (prediction == target) continue;
+
+            ++errors;
+            changed = true;
+            for (int j = 0; j < numInputs; ++j) {
+                deltaWeights[j * classStride + target] += x[j];
+                deltaWeights[j * classStride + prediction] -= x[j];
+            }
+            deltaBias[target] += 1.0f;
+            deltaBias[prediction] -= 1.0f;
+        }
+
+        // Ajuste de pesos basado en los errores del lote
+        if (changed) {
+            k.addScaled(weights.data(), deltaWeights.data(), learningRate, weights.size());
+            k.addScaled(bias.data(), deltaBias.data(), learningRate, bias.size());
+        }
+    }
+    return errors;
+}
+
+size_t Perceptron::trainEpoch(const Dataset& data, size_t batchSize, int numThreads,
+                              std::mt19937& rng) {
+    if (data.numFeatures != static_cast<size_t>(numInputs)) {
+        throw std::invalid_argument("El número de entradas del conjunto no coincide con el del perceptrón.");
+    }
+    for (int label : data.labels) {
+        if (label < 0 || label >= numClasses) {
+            throw std::invalid_argument("El conjunto tiene acciones fuera de las clases del perceptrón.");
+        }
+    }
+    batchSize = std::max<size_t>(batchSize, 1);
+
+    // Orden aleatorio de las filas en cada época
+    std::vector<size_t> order(data.numRows);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    // Cada hilo necesita al menos un lote completo
+    size_t maxThreads = std::max<size_t>(data.numRows / batchSize, 1);
+    int threads = static_cast<int>(std::min<size_t>(std::max(numThreads, 1), maxThreads));
+    if (threads == 1) {
+        return trainShard(data, order, 0, data.numRows, batchSize);
+    }
+
+    // Mezcla de parámetros: cada hilo entrena su propia copia sobre una parte
+    // de la época, partiendo de los pesos actuales, y al final se promedian
+    std::vector<Perceptron> copies(threads, *this);
+    std::vector<size_t> errors(threads, 0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            errors[t] = copies[t].trainShard(data, order, shardBegin(data.numRows, threads, t),
+                                             shardBegin(data.numRows, threads, t + 1), batchSize);
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    const Kernels& k = kernels();
+    const float share = 1.0f / threads;
+    std::fill(weights.begin(), weights.end(), 0.0f);
+    std::fill(bias.begin(), bias.end(), 0.0f);
+    for (int t = 0; t < threads; ++t) {
+        k.addScaled(weights.data(), copies[t].weights.data(), share, weights.size());
+        k.addScaled(bias.data(), copies[t].bias.data(), share, bias.size());
+    }
+
+    return std::accumulate(errors.begin(), errors.end(), static_cast<size_t>(0));
+}
+
+size_t Perceptron::countErrors(const Dataset& data, int numThreads) const {
+    int threads = static_cast<int>(std::min<size_t>(std::max(numThreads, 1),
+                                                    std::max<size_t>(data.numRows, 1)));
+    std::vector<size_t> errors(threads, 0);
+
+    // Las filas del conjunto son contiguas: se predicen por lotes, y cada hilo
+    // reserva una sola vez el espacio de las puntuaciones
+    auto count = [&](int t) {
+        size_t begin = shardBegin(data.numRows, threads, t);
+        size_t end = shardBegin(data.numRows, threads, t + 1);
+        std::vector<int> actions(BATCH_TILE);
+        std::vector<float> score(batchScoreSize());
+        for (size_t start = begin; start < end; start += BATCH_TILE) {
+            size_t rows = std::min(BATCH_TILE, end - start);
+            predictBatch(data.row(start), rows, actions.data(), score.data());
+            for (size_t r = 0; r < rows; ++r) {
+                if (actions[r] != data.labels[start + r]) ++errors[t];
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t) {
+        workers.emplace_back(count, t);
+    }
+    count(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    return std::accumulate(errors.begin(), errors.end(), static_cast<size_t>(0));
 }
 
 // Establecer nuevos pesos
 void Perceptron::setWeights(const std::vector<float>& newWeights) {
-    if (newWeights.size() == weights.size()) {
-        weights = newWeights;
-    } else {
+    if (newWeights.size() != static_cast<size_t>(numClasses) * (numInputs + 1)) {
         throw std::invalid_argument("El tamaño del vector de pesos no coincide con el número de entradas del perceptrón.");
     }
+    for (int c = 0; c < numClasses; ++c) {
+        const float* src = &newWeights[c * (numInputs + 1)];
+        bias[c] = src[0];
+        for (int j = 0; j < numInputs; ++j) {
+            weights[j * classStride + c] = src[1 + j];
+        }
+    }
 }
 
 // Obtener los pesos actuales
 std::vector<float> Perceptron::getWeights() const {
-    return weights;
+    std::vector<float> result;
+    result.reserve(static_cast<size_t>(numClasses) * (numInputs + 1));
+    for (int c = 0; c < numClasses; ++c) {
+        result.push_back(bias[c]);
+        for (int j = 0; j < numInputs; ++j) {
+            result.push_back(weights[j * classStride + c]);
+        }
+    }
+    return result;
 }
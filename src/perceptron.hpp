@@ -1,27 +1,62 @@
 #ifndef PERCEPTRON_HPP
 #define PERCEPTRON_HPP
 
+#include <random>
 #include <vector>
+#include "dataset.hpp"
 
+// Perceptrón multiclase: un peso por entrada y acción y un sesgo por acción;
+// la predicción es la acción con mayor puntuación
 class Perceptron {
 private:
-    std::vector<float> weights;  // Pesos del perceptrón
-    float bias;                  // Sesgo
+    int numInputs;
+    int numClasses;
+    size_t classStride;          // numClasses redondeado a múltiplo de 8 (AVX)
+    std::vector<float> weights;  // Por cada entrada, los pesos de todas las clases
+    std::vector<float> bias;     // Sesgo de cada clase (classStride valores)
     float learningRate;          // Tasa de aprendizaje
 
+    // Calcular la puntuación de todas las clases (classStride valores)
+    void scores(const float* inputs, float* out) const;
+
+    // Como predictBatch, puntuando las filas en score, con espacio para las
+    // de un bloque de filas (batchScoreSize() valores)
+    void predictBatch(const float* inputs, size_t numRows, int* actions, float* score) const;
+    size_t batchScoreSize() const;
+
+    // Entrenar con las filas [begin, end) de order, en mini-lotes
+    size_t trainShard(const Dataset& data, const std::vector<size_t>& order,
+                      size_t begin, size_t end, size_t batchSize);
+
 public:
-    Perceptron(int numInputs, float learningRate = 0.01);
+    Perceptron(int numInputs, int numClasses, float learningRate = 0.01);
+
+    // Predecir la acción para una entrada de numInputs valores
+    int predict(const float* inputs) const;
+    int predict(const std::vector<float>& inputs) const;
 
-    // Predecir la salida basada en las entradas
-    int predict(const std::vector<float>& inputs);
+    // Predecir numRows filas consecutivas de numInputs valores de una vez;
+    // la acción de cada fila se escribe en actions[fila]
+    void predictBatch(const float* inputs, size_t numRows, int* actions) const;
 
     // Entrenar el perceptrón con una entrada y salida esperada
     void train(const std::vector<float>& inputs, int target);
 
-    // Establecer pesos entrenados desde un archivo o vector
+    // Entrenar una época completa en mini-lotes de batchSize filas, repartiendo
+    // el conjunto entre numThreads hilos; devuelve los errores cometidos
+    size_t trainEpoch(const Dataset& data, size_t batchSize, int numThreads, std::mt19937& rng);
+
+    // Contar las filas mal clasificadas, con numThreads hilos
+    size_t countErrors(const Dataset& data, int numThreads) const;
+
+    int getNumInputs() const { return numInputs; }
+    int getNumClasses() const { return numClasses; }
+
+    // Establecer pesos entrenados desde un archivo o vector: por cada clase,
+    // el sesgo seguido de numInputs pesos
     void setWeights(const std::vector<float>& newWeights);
 
-    // Obtener los pesos actuales (para guardarlos en un archivo)
+    // Obtener los pesos actuales (para guardarlos en un archivo), en el mismo formato
     std::vector<float> getWeights() const;
 };
 
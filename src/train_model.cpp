@@ -1,87 +1,101 @@
 #include <iostream>
 #include <fstream>
-#include <sstream>
+#include <chrono>
+#include <cstdint>  // SIZE_MAX
+#include <random>
+#include <string>
+#include <thread>
 #include <vector>
+#include "dataset.hpp"
 #include "perceptron.hpp"
 
 using namespace std;
 
-int main() {
-    ifstream dataFile("data/game_data.csv");
-    if (!dataFile.is_open()) {
-        cerr << "Error al abrir el archivo de datos." << endl;
-        return 1;
+int main(int argc, char* argv[]) {
+    // Archivos de datos: registros binarios de demon_bot (uno por hilo con
+    // --collect) o CSV exportados; por defecto, el de una partida
+    vector<string> dataPaths(argv + 1, argv + argc);
+    if (dataPaths.empty()) {
+        dataPaths.push_back("data/game_data.bin");
     }
 
-    string line;
-    getline(dataFile, line);  // Ignorar la cabecera
-
-    vector<vector<float>> inputs;
-    vector<int> targets;
-
-    // Leer los datos del archivo
-    while (getline(dataFile, line)) {
-        stringstream ss(line);
-        vector<float> input(3);  // Definimos el vector de entrada aquí
-        int action;
-
-        ss >> input[0];  // frame (no lo usamos para el modelo)
-        ss.ignore(1);    // Ignorar la coma
-        ss >> input[0];  // player_x
-        ss.ignore(1);
-        ss >> input[1];  // enemy_x
-        ss.ignore(1);
-        ss >> input[2];  // enemy_y
-        ss.ignore(1);
-        ss >> action;    // action
-
-        // Normalizar las entradas
-        float max_value = 255.0;  // Ajusta según el rango esperado
-        input[0] /= max_value;
-        input[1] /= max_value;
-        input[2] /= max_value;
-
-        inputs.push_back(input);
-        targets.push_back(action);
+    // Leer los datos de los archivos
+    auto start = chrono::steady_clock::now();
+    Dataset data;
+    for (size_t i = 0; i < dataPaths.size(); ++i) {
+        const string& dataPath = dataPaths[i];
+        bool isCsv = dataPath.size() >= 4 && dataPath.compare(dataPath.size() - 4, 4, ".csv") == 0;
+        Dataset part;
+        if (!(isCsv ? loadGameData(dataPath, part) : loadGameLog(dataPath, part))) {
+            cerr << "Error al abrir el archivo de datos: " << dataPath << endl;
+            return 1;
+        }
+        if (i == 0) {
+            data = move(part);
+        } else if (part.numFeatures != data.numFeatures) {
+            cerr << "El archivo " << dataPath << " no tiene las mismas entradas que los anteriores." << endl;
+            return 1;
+        } else {
+            data.append(part);
+        }
     }
+    if (data.numRows == 0) {
+        cerr << "El archivo de datos no contiene ejemplos." << endl;
+        return 1;
+    }
+    double loadSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Ejemplos cargados: " << data.numRows << " (" << loadSeconds << " s)" << endl;
 
-    dataFile.close();
-
-    // Crear el perceptrón
-    Perceptron perceptron(3);  // 3 entradas: player_x, enemy_x, enemy_y
+    // Crear el perceptrón: una entrada por byte de RAM registrado (player_x, enemy_x,
+    // enemy_y) y una salida por acción
+    Perceptron perceptron(static_cast<int>(data.numFeatures), data.numClasses());
     size_t maxEpochs = 1000;
-    float previousError = 0.0f;
+    size_t batchSize = 64;
+    int numThreads = max(1u, thread::hardware_concurrency());
+    size_t patience = 10;      // Épocas sin mejorar antes de parar
+    size_t bestError = SIZE_MAX;
+    size_t epochsWithoutImprovement = 0;
+    vector<float> bestWeights;
+    mt19937 rng(123);  // Semilla fija: el entrenamiento es reproducible
 
     // Entrenar el perceptrón
+    start = chrono::steady_clock::now();
     for (size_t epoch = 1; epoch <= maxEpochs; ++epoch) {
-        float totalError = 0.0f;
-
-        for (size_t i = 0; i < inputs.size(); ++i) {
-            int prediction = perceptron.predict(inputs[i]);
-            int error = targets[i] - prediction;
-            totalError += abs(error);  // Suma del error absoluto
-            perceptron.train(inputs[i], targets[i]);
-        }
+        // Errores cometidos durante la época, lote a lote
+        size_t totalError = perceptron.trainEpoch(data, batchSize, numThreads, rng);
 
         // Mostrar el progreso
         cout << "Época: " << epoch << " | Error Total: " << totalError << endl;
 
-        // Condición de convergencia
-        if (abs(totalError - previousError) < 1e-5) {
+        // Condición de convergencia: sin errores, o sin mejorar durante varias
+        // épocas (con datos ruidosos el error nunca llega a 0)
+        if (totalError < bestError) {
+            bestError = totalError;
+            bestWeights = perceptron.getWeights();
+            epochsWithoutImprovement = 0;
+        } else {
+            ++epochsWithoutImprovement;
+        }
+        if (totalError == 0 || epochsWithoutImprovement >= patience) {
             cout << "Convergencia alcanzada después de " << epoch << " épocas." << endl;
             break;
         }
-
-        previousError = totalError;
     }
+    perceptron.setWeights(bestWeights);  // Quedarse con los mejores pesos
+    double trainSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
 
-    cout << "Entrenamiento completado." << endl;
+    size_t errors = perceptron.countErrors(data, numThreads);
+    cout << "Entrenamiento completado en " << trainSeconds << " s. Precisión: "
+         << 100.0 * (data.numRows - errors) / data.numRows << "%" << endl;
 
-    // Guardar los pesos entrenados
+    // Guardar los pesos entrenados: clases y entradas, y después el sesgo y
+    // los pesos de cada clase
     ofstream weightsFile("data/perceptron_weights.txt");
     if (weightsFile.is_open()) {
-        for (float weight : perceptron.getWeights()) {
-            weightsFile << weight << " ";
+        weightsFile << perceptron.getNumClasses() << " " << perceptron.getNumInputs() << "\n";
+        vector<float> weights = perceptron.getWeights();
+        for (size_t i = 0; i < weights.size(); ++i) {
+            weightsFile << weights[i] << ((i + 1) % (perceptron.getNumInputs() + 1) == 0 ? "\n" : " ");
         }
         weightsFile.close();
         cout << "Pesos guardados correctamente en data/perceptron_weights.txt" << endl;
@@ -0,0 +1,141 @@
+// Pruebas de carga de datos y entrenamiento con etiquetas fuera de rango
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "../src/dataset.hpp"
+#include "../src/game_log.hpp"
+#include "../src/perceptron.hpp"
+
+using namespace std;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        cerr << "FALLO: " << what << endl;
+        ++failures;
+    }
+}
+
+// Crear un archivo temporal con un nombre único, en TMPDIR o /tmp, para que
+// varias ejecuciones de la prueba no se pisen
+static string tempFile() {
+    const char* dir = getenv("TMPDIR");
+    string path = string(dir && *dir ? dir : "/tmp") + "/test_datasetXXXXXX";
+    int fd = mkstemp(&path[0]);
+    if (fd < 0) return "";
+    close(fd);
+    return path;
+}
+
+// Las filas del CSV con una acción fuera de [0, NUM_ACTIONS) se ignoran
+static void csvBadLabels() {
+    string path = tempFile();
+    check(!path.empty(), "se crea el CSV temporal");
+    {
+        ofstream csv(path);
+        csv << "frame,player_x,enemy_x,enemy_y,action\n"
+            << "1,10,20,30,-1\n"
+            << "2,10,20,30,3\n"
+            << "3,10,20,30,18\n";
+    }
+    Dataset data;
+    check(loadGameData(path, data), "el CSV se carga");
+    check(data.numRows == 1, "solo queda la fila con acción válida");
+    check(data.numRows == 1 && data.labels[0] == 3, "la etiqueta válida se conserva");
+    remove(path.c_str());
+}
+
+// Un registro binario con una acción fuera de rango se rechaza
+static void logBadLabels() {
+    string path = tempFile();
+    check(!path.empty(), "se crea el registro temporal");
+    GameLogWriter log;
+    check(log.open(path, {20, 30, 31}), "el registro se crea");
+    uint8_t features[3] = {10, 20, 30};
+    log.append(1, features, 3, 0);
+    log.append(2, features, 200, 0);
+    check(log.close(), "el registro se guarda");
+
+    Dataset data;
+    check(!loadGameLog(path, data), "el registro con acciones inválidas se rechaza");
+    remove(path.c_str());
+}
+
+// El perceptrón no acepta acciones esperadas fuera de sus clases
+static void perceptronBadLabels() {
+    Perceptron perceptron(3, 4);
+    bool thrown = false;
+    try {
+        perceptron.train({0.1f, 0.2f, 0.3f}, -1);
+    } catch (const invalid_argument&) {
+        thrown = true;
+    }
+    check(thrown, "train() rechaza una acción negativa");
+
+    Dataset data(3);
+    float row[3] = {0.1f, 0.2f, 0.3f};
+    data.addRow(row, 1);
+    data.addRow(row, 4);
+    mt19937 rng(1);
+    thrown = false;
+    try {
+        perceptron.trainEpoch(data, 64, 1, rng);
+    } catch (const invalid_argument&) {
+        thrown = true;
+    }
+    check(thrown, "trainEpoch() rechaza una acción fuera de las clases");
+}
+
+// predictBatch y countErrors dan las mismas acciones que predict fila a fila,
+// también en el último bloque incompleto y con un número de entradas y clases
+// que no es múltiplo de 8
+static void predictBatchMatchesPredict() {
+    const int numInputs = 37;
+    Perceptron perceptron(numInputs, NUM_ACTIONS);
+    mt19937 rng(1);
+    uniform_real_distribution<float> value(-1.0f, 1.0f);
+    vector<float> weights(NUM_ACTIONS * (numInputs + 1));
+    for (float& w : weights) w = value(rng);
+    perceptron.setWeights(weights);
+
+    Dataset data(numInputs);
+    vector<float> row(numInputs);
+    for (int i = 0; i < 150; ++i) {
+        for (float& x : row) x = value(rng);
+        data.addRow(row.data(), static_cast<int>(rng() % NUM_ACTIONS));
+    }
+
+    vector<int> actions(data.numRows);
+    perceptron.predictBatch(data.row(0), data.numRows, actions.data());
+    size_t mismatches = 0;
+    size_t errors = 0;
+    for (size_t i = 0; i < data.numRows; ++i) {
+        int action = perceptron.predict(data.row(i));
+        if (actions[i] != action) ++mismatches;
+        if (action != data.labels[i]) ++errors;
+    }
+    check(mismatches == 0, "predictBatch coincide con predict en cada fila");
+    check(perceptron.countErrors(data, 1) == errors, "countErrors con un hilo cuenta los errores de predict");
+    check(perceptron.countErrors(data, 3) == errors, "countErrors con tres hilos cuenta los errores de predict");
+}
+
+int main() {
+    csvBadLabels();
+    logBadLabels();
+    perceptronBadLabels();
+    predictBatchMatchesPredict();
+
+    if (failures > 0) {
+        cerr << failures << " comprobaciones fallidas" << endl;
+        return 1;
+    }
+    cout << "test_dataset: OK" << endl;
+    return 0;
+}